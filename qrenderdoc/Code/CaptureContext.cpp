@@ -1637,6 +1637,29 @@ void CaptureContext::SetEventID(const rdcarray<ICaptureViewer *> &exclude, uint3
   bool updateEvent = force || prevEventID != eventId;
 
   RefreshUIStatus(exclude, updateSelectedEvent, updateEvent);
+
+  // once things settle, fetch the state at the next few actions in the background so that stepping
+  // forward through them doesn't have to wait for it
+  rdcarray<uint32_t> prefetchEvents;
+  const ActionDescription *action = GetAction(eventId);
+  for(int i = 0; action && action->next && i < 2; i++)
+  {
+    action = action->next;
+    prefetchEvents.push_back(action->eventId);
+  }
+
+  if(!prefetchEvents.isEmpty())
+  {
+    m_Replay.SpeculativeInvoke([this, prefetchEvents](IReplayController *r) {
+      for(uint32_t eid : prefetchEvents)
+      {
+        if(m_Replay.SpeculationCancelled())
+          return;
+
+        r->PrefetchFrameEvent(eid);
+      }
+    });
+  }
 }
 
 void CaptureContext::ConnectToRemoteServer(RemoteHost host)
@@ -293,6 +293,18 @@ void ReplayManager::BlockInvoke(ReplayManager::InvokeCallback m)
   delete cmd;
 }
 
+void ReplayManager::SpeculativeInvoke(ReplayManager::InvokeCallback m)
+{
+  QMutexLocker autolock(&m_RenderLock);
+  m_SpeculativeInvoke = m;
+}
+
+bool ReplayManager::SpeculationCancelled()
+{
+  QMutexLocker autolock(&m_RenderLock);
+  return m_SpeculationCancelled;
+}
+
 void ReplayManager::CancelReplayLoop()
 {
   m_Renderer->CancelReplayLoop();
@@ -431,6 +443,8 @@ void ReplayManager::PushInvoke(ReplayManager::InvokeHandle *cmd)
 
   QMutexLocker autolock(&m_RenderLock);
   m_RenderQueue.enqueue(cmd);
+  m_SpeculativeInvoke = NULL;
+  m_SpeculationCancelled = true;
   m_RenderCondition.wakeAll();
 }
 
@@ -467,10 +481,17 @@ void ReplayManager::run(int proxyRenderer, const QString &capturefile, const Rep
 
   m_Running = true;
 
+  // how long the queue must be empty before running speculative work. Selecting an event is
+  // usually followed by a burst of requests from each viewer, which we don't want to delay.
+  const qint64 speculationIdleMS = 250;
+
+  m_IdleTimer.start();
+
   // main render command loop
   while(m_Running)
   {
     InvokeHandle *cmd = NULL;
+    InvokeCallback speculative;
 
     // wait for the condition to be woken, grab top of current queue,
     // unlock again.
@@ -480,7 +501,29 @@ void ReplayManager::run(int proxyRenderer, const QString &capturefile, const Rep
         m_RenderCondition.wait(&m_RenderLock, 10);
 
       if(!m_RenderQueue.isEmpty())
+      {
         cmd = m_RenderQueue.dequeue();
+      }
+      else if(m_SpeculativeInvoke && m_IdleTimer.hasExpired(speculationIdleMS))
+      {
+        speculative = m_SpeculativeInvoke;
+        m_SpeculativeInvoke = NULL;
+        m_SpeculationCancelled = false;
+      }
+    }
+
+    if(speculative)
+    {
+      speculative(m_Renderer);
+
+      ResultDetails err = m_Renderer->GetFatalErrorStatus();
+      if(m_FatalError.OK() && !err.OK())
+      {
+        m_FatalError = err;
+        m_FatalErrorCallback();
+      }
+
+      continue;
     }
 
     if(cmd == NULL)
@@ -510,6 +553,8 @@ void ReplayManager::run(int proxyRenderer, const QString &capturefile, const Rep
       }
     }
 
+    m_IdleTimer.start();
+
     // if it's a throwaway command, delete it
     if(cmd->selfdelete)
       delete cmd;
@@ -68,6 +68,13 @@ public:
   void AsyncInvoke(InvokeCallback m);
   void BlockInvoke(InvokeCallback m);
 
+  // queues low priority work, such as prefetching, that only runs once the replay thread has been
+  // idle for a while. Only the most recent speculative invoke is kept, and it's dropped if any other
+  // request arrives before it starts. While running, it should check SpeculationCancelled() between
+  // steps and stop early once a real request is waiting.
+  void SpeculativeInvoke(InvokeCallback m);
+  bool SpeculationCancelled();
+
   void CancelReplayLoop();
 
   void CloseThread();
@@ -128,6 +135,10 @@ private:
   QQueue<InvokeHandle *> m_RenderQueue;
   QWaitCondition m_RenderCondition;
 
+  InvokeCallback m_SpeculativeInvoke;
+  bool m_SpeculationCancelled = false;
+  QElapsedTimer m_IdleTimer;
+
   ICaptureFile *m_CaptureFile = NULL;
   IReplayController *m_Renderer = NULL;
 
@@ -4289,6 +4289,31 @@ void BufferViewer::UI_RemoveOffsets(RDTreeWidgetItem *root)
   }
 }
 
+static bool CanCalculateBoundsInCore(const ShaderConstant &el, const BufferElementProperties &prop)
+{
+  // matrices, bitfields and enums need the full interpretation from GetVariants
+  if(el.type.rows > 1 || el.bitFieldSize != 0 || el.type.baseType == VarType::Enum)
+    return false;
+
+  const ResourceFormat &fmt = prop.format;
+
+  if(fmt.type == ResourceFormatType::R10G10B10A2 || fmt.type == ResourceFormatType::R11G11B10)
+    return true;
+
+  if(fmt.type != ResourceFormatType::Regular || fmt.compType == CompType::Depth)
+    return false;
+
+  // 64-bit integers and 32-bit normalised values are interpreted differently
+  if(fmt.compByteWidth == 8)
+    return fmt.compType == CompType::Float;
+
+  if(fmt.compByteWidth == 4)
+    return fmt.compType != CompType::UNorm && fmt.compType != CompType::SNorm &&
+           fmt.compType != CompType::UNormSRGB;
+
+  return fmt.compByteWidth == 1 || fmt.compByteWidth == 2;
+}
+
 void BufferViewer::calcBoundingData(CalcBoundingBoxData &bbox)
 {
   for(size_t stage = 0; stage < ARRAY_COUNT(bbox.input); stage++)
@@ -4320,10 +4345,62 @@ void BufferViewer::calcBoundingData(CalcBoundingBoxData &bbox)
 
     CacheDataForIteration(cache, s.columns, s.props, s.buffers, bbox.input[0].curInstance);
 
-    // possible optimisation here if this shows up as a hot spot - sort and unique the indices and
-    // iterate in ascending order, to be more cache friendly
+    // most columns are simple vectors which the core can decode and reduce in bulk, with sorted
+    // unique index iteration. Anything else falls back to the per-row interpretation below
+    QVector<bool> slowColumns(s.columns.count(), false);
+    bool anySlow = false;
+
+    const bytebuf noIndices;
+
+    for(int col = 0; col < s.columns.count(); col++)
+    {
+      const CachedElData &d = cache[col];
+
+      // per-primitive data can't be read per-vertex so never contributes
+      if(!d.data || d.prop->perprimitive)
+        continue;
+
+      if(!CanCalculateBoundsInCore(*d.el, *d.prop))
+      {
+        slowColumns[col] = anySlow = true;
+        continue;
+      }
+
+      const BufferData *buf = s.buffers[d.prop->buffer];
+      const uint64_t offset = uint64_t(d.data - buf->data());
 
-    for(uint32_t row = 0; row < s.numRows; row++)
+      rdcpair<FloatVector, FloatVector> bounds;
+
+      if(d.prop->perinstance)
+      {
+        // every row reads the same element, so only one needs to be decoded
+        bounds = RENDERDOC_CalculateVertexBounds(d.prop->format, buf->storage, offset,
+                                                 (uint32_t)d.stride, s.numRows > 0 ? 1 : 0,
+                                                 noIndices, 0, 0, 0);
+      }
+      else if(s.indices && s.indices->hasData())
+      {
+        bounds = RENDERDOC_CalculateVertexBounds(d.prop->format, buf->storage, offset,
+                                                 (uint32_t)d.stride, s.numRows, s.indices->storage,
+                                                 sizeof(uint32_t), s.baseVertex, s.primRestart);
+      }
+      else
+      {
+        bounds = RENDERDOC_CalculateVertexBounds(d.prop->format, buf->storage, offset,
+                                                 (uint32_t)d.stride, s.numRows, noIndices, 0, 0, 0);
+      }
+
+      float *minOut = (float *)&minOutputList[col];
+      float *maxOut = (float *)&maxOutputList[col];
+
+      for(int comp = 0; comp < 4 && comp < d.numColumns; comp++)
+      {
+        minOut[comp] = qMin(minOut[comp], (&bounds.first.x)[comp]);
+        maxOut[comp] = qMax(maxOut[comp], (&bounds.second.x)[comp]);
+      }
+    }
+
+    for(uint32_t row = 0; anySlow && row < s.numRows; row++)
     {
       uint32_t idx = row;
 
@@ -4337,6 +4414,9 @@ void BufferViewer::calcBoundingData(CalcBoundingBoxData &bbox)
 
       for(int col = 0; col < s.columns.count(); col++)
       {
+        if(!slowColumns[col])
+          continue;
+
         const CachedElData &d = cache[col];
         const ShaderConstant *el = d.el;
         const BufferElementProperties *prop = d.prop;
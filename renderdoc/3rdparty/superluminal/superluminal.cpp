@@ -100,10 +100,10 @@ void Init()
     RDCEraseEl(funcTable);
 }
 
-void BeginProfileRange(const rdcstr &name)
+void BeginProfileRange(const char *name)
 {
   if(funcTable.BeginEvent)
-    funcTable.BeginEvent("RenderDoc", name.c_str(), PERFORMANCEAPI_DEFAULT_COLOR);
+    funcTable.BeginEvent("RenderDoc", name, PERFORMANCEAPI_DEFAULT_COLOR);
 }
 
 void EndProfileRange()
@@ -27,6 +27,6 @@
 namespace Superluminal
 {
 void Init();
-void BeginProfileRange(const rdcstr &name);
+void BeginProfileRange(const char *name);
 void EndProfileRange();
 };
@@ -627,6 +627,23 @@ It is an :class:`AlphaMapping` that controls what behaviour to use.
 
   DOCUMENT("The quality to use when saving to a ``JPG`` file. Valid values are between 1 and 100.");
   int jpegQuality = 90;
+
+  DOCUMENT(R"(When saving to a ``DDS`` file, block compress the data to this format.
+
+Only :attr:`ResourceFormatType.BC1` through :attr:`ResourceFormatType.BC7` are supported. Any other
+value, including the default of :attr:`ResourceFormatType.Undefined`, saves the data in its
+original format. Textures that are already block compressed are not re-encoded.
+
+BC6 is encoded as unsigned, and BC1-3 and BC7 are encoded as sRGB if the source texture is sRGB.
+)");
+  ResourceFormatType blockCompression = ResourceFormatType::Undefined;
+
+  DOCUMENT(R"(The speed/quality trade-off to use when encoding to :data:`blockCompression`.
+
+:attr:`QualityHint.Fastest` is suitable for previews, :attr:`QualityHint.Nicest` does an exhaustive
+search which for BC6 and BC7 can be very slow on large textures.
+)");
+  QualityHint blockCompressionQuality = QualityHint::DontCare;
 };
 
 DECLARE_REFLECTION_STRUCT(TextureSave);
@@ -1220,3 +1237,5 @@ DECLARE_REFLECTION_STRUCT(ExecuteResult);
 typedef std::function<bool()> RENDERDOC_KillCallback;
 typedef std::function<void(float)> RENDERDOC_ProgressCallback;
 typedef std::function<WindowingData(bool, const rdcarray<WindowingSystem> &)> RENDERDOC_PreviewWindowCallback;
+struct IReplayController;
+typedef std::function<void(IReplayController *, uint32_t)> RENDERDOC_ReplayJobCallback;
@@ -428,6 +428,16 @@ well as control the replay and analysis functionality available.
     created.
   :rtype: WindowingData
 
+.. function:: ReplayJobCallback()
+
+  Not an actual member function - the signature for any ``ReplayJobCallback`` callbacks.
+
+  Called to run one job of several independent jobs on one of a set of replays, see
+  :meth:`CaptureFile.RunReplayJobs`.
+
+  :param ReplayController controller: The replay to run the job on.
+  :param int jobIndex: The index of the job to run.
+
 .. data:: NoPreference
 
   No preference for a particular value, see :meth:`ReplayController.DebugPixel`.
@@ -494,6 +504,17 @@ function must be called from another thread.
 )");
   virtual void SetFrameEvent(uint32_t eventId, bool force) = 0;
 
+  DOCUMENT(R"(Fetch the pipeline state at the given :data:`eventId <APIEvent.eventId>` ahead of time,
+so that a later :meth:`SetFrameEvent` to that event doesn't need to fetch it again.
+
+The current event and its pipeline state are unchanged once this returns, but it replays the capture
+to the given event and back so it should only be used speculatively when the replay is otherwise
+idle.
+
+:param int eventId: The :data:`eventId <APIEvent.eventId>` to prefetch.
+)");
+  virtual void PrefetchFrameEvent(uint32_t eventId) = 0;
+
   DOCUMENT(R"(Retrieve the current :class:`D3D11State` pipeline state.
 
 The return value will be ``None`` if the capture is not using the D3D11 API.
@@ -1662,6 +1683,32 @@ by the :class:`ReplayController`.
   virtual rdcpair<ResultDetails, IReplayController *> OpenCapture(
       const ReplayOptions &opts, RENDERDOC_ProgressCallback progress) = 0;
 
+  DOCUMENT(R"(Opens several independent replays of this capture locally, and runs a set of
+independent jobs across them in parallel. Only supported for handles opened with a native ``rdc``
+capture, otherwise this will fail.
+
+Each replay runs on its own thread, and jobs are handed out to whichever replay is free next so the
+order in which jobs run is undefined. A job must not rely on the current event or any other state
+left behind by a previous job, as the next job on the same replay could be any index. The
+:class:`ReplayController` passed to each job is only valid for the duration of that call, and must
+not be shut down.
+
+This function will block until all jobs have completed.
+
+:param ReplayOptions opts: The options controlling how the capture should be replayed.
+:param int numReplays: The number of replays to open. Each replay has the full memory cost of
+  opening the capture, so this should be chosen with that in mind.
+:param int numJobs: The number of jobs to run, with indices from ``0`` to ``numJobs - 1``.
+:param ReplayJobCallback job: The callback to run each job.
+:param ProgressCallback progress: A callback that will be repeatedly called with an updated progress
+  value as jobs complete. Can be ``None`` if no progress is desired.
+:return: The status of running the jobs, whether success or failure.
+:rtype: ResultDetails
+)");
+  virtual ResultDetails RunReplayJobs(const ReplayOptions &opts, uint32_t numReplays,
+                                      uint32_t numJobs, RENDERDOC_ReplayJobCallback job,
+                                      RENDERDOC_ProgressCallback progress) = 0;
+
   DOCUMENT(R"(Returns the structured data for this capture.
 
 The lifetime of this data is scoped to the lifetime of the capture handle, so it cannot be used
@@ -1843,6 +1890,35 @@ case of strip topologies.
 extern "C" RENDERDOC_API uint32_t RENDERDOC_CC RENDERDOC_VertexOffset(Topology topology,
                                                                       uint32_t primitive);
 
+DOCUMENT(R"(A utility function that calculates the per-component minimum and maximum values of a
+vertex attribute, such as for the bounding box of mesh positions.
+
+The vertices are decoded and reduced in parallel. If an index buffer is provided, each referenced
+vertex is only decoded once and they are processed in ascending order regardless of how the indices
+are ordered. Any vertices which would read past the end of :paramref:`CalculateVertexBounds.data`
+are skipped, as are any components which are infinite or NaN.
+
+:param ResourceFormat format: The format of the attribute.
+:param bytes data: The vertex buffer data.
+:param int offset: The byte offset in :paramref:`CalculateVertexBounds.data` to the attribute in
+  the first vertex.
+:param int stride: The byte stride between vertices.
+:param int numVerts: The number of vertices to process, or the number of indices if
+  :paramref:`CalculateVertexBounds.indices` is not empty.
+:param bytes indices: The index buffer data, or empty to process vertices in order.
+:param int indexByteWidth: The width in bytes of each index in
+  :paramref:`CalculateVertexBounds.indices`. Must be 1, 2 or 4.
+:param int baseVertex: The base vertex to add to each index.
+:param int primRestart: The primitive restart index to skip, or 0 if primitive restart is disabled.
+:return: A pair of the minimum and maximum values. Components not present in the format are 0, and
+  components with no finite values are left at the largest and smallest float respectively.
+:rtype: Tuple[FloatVector,FloatVector]
+)");
+extern "C" RENDERDOC_API rdcpair<FloatVector, FloatVector> RENDERDOC_CC
+RENDERDOC_CalculateVertexBounds(const ResourceFormat &format, const bytebuf &data, uint64_t offset,
+                                uint32_t stride, uint32_t numVerts, const bytebuf &indices,
+                                uint32_t indexByteWidth, int32_t baseVertex, uint32_t primRestart);
+
 //////////////////////////////////////////////////////////////////////////
 // Create a capture file handle.
 //////////////////////////////////////////////////////////////////////////
@@ -2356,6 +2432,10 @@ extern "C" RENDERDOC_API int RENDERDOC_CC RENDERDOC_RunFunctionalTests(int pytho
 DOCUMENT("INTERNAL: Begin a profile region.");
 extern "C" RENDERDOC_API void RENDERDOC_CC RENDERDOC_BeginProfileRegion(const rdcstr &name);
 
+DOCUMENT(
+    "INTERNAL: Begin a profile region with a name that stays valid for the lifetime of the process.");
+extern "C" RENDERDOC_API void RENDERDOC_CC RENDERDOC_BeginStaticProfileRegion(const char *name);
+
 DOCUMENT("INTERNAL: End a profile region.");
 extern "C" RENDERDOC_API void RENDERDOC_CC RENDERDOC_EndProfileRegion();
 
@@ -2368,6 +2448,8 @@ extern "C" RENDERDOC_API void RENDERDOC_CC RENDERDOC_EndProfileRegion();
 
 struct RENDERDOC_ProfileRegion
 {
+  // literals and __PRETTY_FUNCTION__ are passed through without constructing a string
+  RENDERDOC_ProfileRegion(const char *name) { RENDERDOC_BeginStaticProfileRegion(name); }
   RENDERDOC_ProfileRegion(const rdcstr &name) { RENDERDOC_BeginProfileRegion(name); }
   ~RENDERDOC_ProfileRegion() { RENDERDOC_EndProfileRegion(); }
 };
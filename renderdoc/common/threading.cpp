@@ -0,0 +1,180 @@
+/******************************************************************************
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019-2024 Baldur Karlsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include "common/threading.h"
+#include <algorithm>
+#include <thread>
+#include "core/settings.h"
+#include "strings/string_utils.h"
+
+RDOC_CONFIG(uint32_t, Threading_MaxWorkerThreads, 0,
+            "The maximum number of threads to use for parallel processing such as converting and "
+            "compressing textures on save. 0 uses one thread per core, 1 disables threading.");
+
+namespace Threading
+{
+// read on every SCOPED_*LOCK through IsLockProfilingActive(). This can be toggled at any time, a
+// lock that races with the toggle is simply recorded or not.
+int32_t LockProfilingActive = 0;
+
+// intrusive list of every lock site that has been hit while profiling was active. Sites are static
+// so they are never removed, only their counters are reset.
+static LockSite *lockSites = NULL;
+static SpinLock lockSitesLock;
+
+void EnableLockProfiling(bool enable)
+{
+  int32_t prev = Atomic::Exch32(&LockProfilingActive, enable ? 1 : 0);
+
+  if((prev != 0) != enable)
+    RDCLOG("Lock contention profiling %s", enable ? "enabled" : "disabled");
+}
+
+void RecordLockAcquire(LockSite *site, bool contended, uint64_t waitTicks)
+{
+  if(Atomic::CmpExch32(&site->registered, 0, 1) == 0)
+  {
+    // this can't use SCOPED_SPINLOCK or we would recurse back into here
+    lockSitesLock.Lock();
+    site->next = lockSites;
+    lockSites = site;
+    lockSitesLock.Unlock();
+  }
+
+  Atomic::Inc64(&site->acquires);
+
+  if(contended)
+  {
+    Atomic::Inc64(&site->contended);
+    Atomic::ExchAdd64(&site->waitTicks, (int64_t)waitTicks);
+  }
+}
+
+rdcarray<LockSite> FetchLockProfile()
+{
+  rdcarray<LockSite> sites;
+
+  lockSitesLock.Lock();
+  for(LockSite *site = lockSites; site; site = site->next)
+  {
+    sites.push_back(*site);
+
+    Atomic::ExchAdd64(&site->acquires, -sites.back().acquires);
+    Atomic::ExchAdd64(&site->contended, -sites.back().contended);
+    Atomic::ExchAdd64(&site->waitTicks, -sites.back().waitTicks);
+  }
+  lockSitesLock.Unlock();
+
+  return sites;
+}
+
+void ResetLockProfile()
+{
+  if(IsLockProfilingActive())
+    FetchLockProfile();
+}
+
+rdcarray<LockSite> DumpLockProfile()
+{
+  rdcarray<LockSite> sites = FetchLockProfile();
+
+  rdcarray<LockSite> contended;
+  for(const LockSite &site : sites)
+    if(site.contended > 0)
+      contended.push_back(site);
+
+  if(contended.empty())
+  {
+    RDCLOG("No lock contention recorded");
+    return sites;
+  }
+
+  std::sort(contended.begin(), contended.end(),
+            [](const LockSite &a, const LockSite &b) { return a.waitTicks > b.waitTicks; });
+
+  const double ticksPerMS = Timing::GetTickFrequency();
+
+  const size_t maxSites = 32;
+
+  RDCLOG("Lock contention report, %u contended sites:", (uint32_t)contended.size());
+  for(size_t i = 0; i < contended.size() && i < maxSites; i++)
+  {
+    const LockSite &site = contended[i];
+    double waitMS = double(site.waitTicks) / ticksPerMS;
+    RDCLOG("  %s:%d - %.3f ms waiting, %lld/%lld acquires contended (avg %.3f us)",
+           get_basename(site.file).c_str(), site.line, waitMS, site.contended, site.acquires,
+           (waitMS * 1000.0) / double(site.contended));
+  }
+
+  return sites;
+}
+
+uint32_t GetWorkerThreadCount()
+{
+  uint32_t count = Threading_MaxWorkerThreads();
+
+  if(count == 0)
+    count = std::thread::hardware_concurrency();
+
+  return RDCMAX(1U, count);
+}
+
+void ParallelFor(uint32_t count, std::function<void(uint32_t)> func)
+{
+  const uint32_t numThreads = RDCMIN(count, GetWorkerThreadCount());
+
+  if(numThreads <= 1)
+  {
+    for(uint32_t i = 0; i < count; i++)
+      func(i);
+    return;
+  }
+
+  int32_t next = 0;
+
+  auto worker = [&]() {
+    for(;;)
+    {
+      int32_t i = Atomic::Inc32(&next) - 1;
+      if(i >= (int32_t)count)
+        break;
+      func((uint32_t)i);
+    }
+  };
+
+  rdcarray<ThreadHandle> threads;
+  threads.reserve(numThreads - 1);
+  for(uint32_t t = 1; t < numThreads; t++)
+    threads.push_back(CreateThread(worker));
+
+  // the calling thread works too rather than idling on the join
+  worker();
+
+  for(ThreadHandle t : threads)
+  {
+    JoinThread(t);
+    CloseThread(t);
+  }
+}
+};
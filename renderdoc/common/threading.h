@@ -28,15 +28,85 @@
 #include "common/common.h"
 #include "os/os_specific.h"
 
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#include <emmintrin.h>
+#elif defined(_M_ARM64) || defined(_M_ARM)
+#include <intrin.h>
+#endif
+
 namespace Threading
 {
+// hint to the CPU that we're in a spin-wait loop, so it can back off and avoid hammering the cache
+// line or starving a hyperthread sibling.
+inline void SpinPause()
+{
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+  _mm_pause();
+#elif defined(_M_ARM64) || defined(_M_ARM)
+  __yield();
+#elif defined(__aarch64__) || defined(__arm__)
+  __asm__ __volatile__("yield");
+#endif
+}
+
+// a lock site is declared statically by each of the SCOPED_*LOCK macros below and identifies the
+// file/line where a lock is taken. When lock profiling is enabled the time spent waiting to
+// acquire is accumulated per-site and can be dumped with DumpLockProfile().
+struct LockSite
+{
+  const char *file;
+  int line;
+  int32_t registered;
+  int64_t acquires;
+  int64_t contended;
+  int64_t waitTicks;
+  LockSite *next;
+};
+
+extern int32_t LockProfilingActive;
+
+inline bool IsLockProfilingActive()
+{
+  return Atomic::Load32(&LockProfilingActive) != 0;
+}
+
+void EnableLockProfiling(bool enable);
+void RecordLockAcquire(LockSite *site, bool contended, uint64_t waitTicks);
+
+// returns a snapshot of every site recorded so far and resets their counters
+rdcarray<LockSite> FetchLockProfile();
+// reset the counters if profiling is active, e.g. at the start of a capture
+void ResetLockProfile();
+// as FetchLockProfile(), but also logs a report of the most contended sites
+rdcarray<LockSite> DumpLockProfile();
+
+// acquire a lock via the given try/lock functions, recording how long we waited against the site.
+template <typename TryLockFunc, typename LockFunc>
+void ProfiledLock(LockSite *site, TryLockFunc tryLock, LockFunc lock)
+{
+  if(tryLock())
+  {
+    RecordLockAcquire(site, false, 0);
+    return;
+  }
+
+  uint64_t start = Timing::GetTick();
+  lock();
+  RecordLockAcquire(site, true, Timing::GetTick() - start);
+}
+
 class ScopedLock
 {
 public:
-  ScopedLock(CriticalSection *cs) : m_CS(cs)
+  ScopedLock(CriticalSection *cs, LockSite *site = NULL) : m_CS(cs)
   {
     if(m_CS)
-      m_CS->Lock();
+    {
+      if(site && IsLockProfilingActive())
+        ProfiledLock(site, [cs]() { return cs->Trylock(); }, [cs]() { cs->Lock(); });
+      else
+        m_CS->Lock();
+    }
   }
   ~ScopedLock()
   {
@@ -51,7 +121,13 @@ private:
 class ScopedReadLock
 {
 public:
-  ScopedReadLock(RWLock &rw) : m_RW(&rw) { m_RW->ReadLock(); }
+  ScopedReadLock(RWLock &rw, LockSite *site = NULL) : m_RW(&rw)
+  {
+    if(site && IsLockProfilingActive())
+      ProfiledLock(site, [&rw]() { return rw.TryReadlock(); }, [&rw]() { rw.ReadLock(); });
+    else
+      m_RW->ReadLock();
+  }
   ~ScopedReadLock() { m_RW->ReadUnlock(); }
 private:
   RWLock *m_RW;
@@ -60,25 +136,58 @@ private:
 class ScopedWriteLock
 {
 public:
-  ScopedWriteLock(RWLock &rw) : m_RW(&rw) { m_RW->WriteLock(); }
+  ScopedWriteLock(RWLock &rw, LockSite *site = NULL) : m_RW(&rw)
+  {
+    if(site && IsLockProfilingActive())
+      ProfiledLock(site, [&rw]() { return rw.TryWritelock(); }, [&rw]() { rw.WriteLock(); });
+    else
+      m_RW->WriteLock();
+  }
   ~ScopedWriteLock() { m_RW->WriteUnlock(); }
 private:
   RWLock *m_RW;
 };
 
+// The lock word is 0 when unlocked, 1 when locked with no waiters, and 2 when locked and there
+// may be threads parked on it. Contended lockers spin for a short bounded period with pause
+// instructions and exponential backoff, and then park on the lock word until woken by Unlock().
 class SpinLock
 {
 public:
   void Lock()
   {
-    while(!Trylock())
+    if(Trylock())
+      return;
+
+    uint32_t backoff = 1;
+    for(uint32_t i = 0; i < SpinIterations; i++)
     {
-      // spin!
+      for(uint32_t p = 0; p < backoff; p++)
+        SpinPause();
+
+      if(Trylock())
+        return;
+
+      if(backoff < MaxBackoff)
+        backoff <<= 1;
     }
+
+    // mark the lock as contended. If it was unlocked in the meantime we now own it - with a
+    // pessimistic contended state, which only costs an unnecessary wake on unlock.
+    while(Atomic::Exch32(&val, 2) != 0)
+      Threading::WaitOnAddress(&val, 2);
   }
   bool Trylock() { return Atomic::CmpExch32(&val, 0, 1) == 0; }
-  void Unlock() { Atomic::CmpExch32(&val, 1, 0); }
+  void Unlock()
+  {
+    if(Atomic::Exch32(&val, 0) == 2)
+      Threading::WakeAddress(&val);
+  }
+
 private:
+  static const uint32_t SpinIterations = 16;
+  static const uint32_t MaxBackoff = 64;
+
   int32_t val = 0;
 };
 
@@ -86,7 +195,13 @@ class ScopedSpinLock
 {
 public:
   ScopedSpinLock() = default;
-  ScopedSpinLock(SpinLock &spin) : m_Spin(&spin) { m_Spin->Lock(); }
+  ScopedSpinLock(SpinLock &spin, LockSite *site = NULL) : m_Spin(&spin)
+  {
+    if(site && IsLockProfilingActive())
+      ProfiledLock(site, [&spin]() { return spin.Trylock(); }, [&spin]() { spin.Lock(); });
+    else
+      m_Spin->Lock();
+  }
   ScopedSpinLock(const ScopedSpinLock &) = delete;
   ScopedSpinLock &operator=(const ScopedSpinLock &) = delete;
   ScopedSpinLock &operator=(ScopedSpinLock &&other)
@@ -110,13 +225,34 @@ public:
 private:
   SpinLock *m_Spin = NULL;
 };
+
+// the number of threads that ParallelFor will use at most, including the calling thread
+uint32_t GetWorkerThreadCount();
+
+// call func(i) for every i in [0, count) spread across worker threads, returning once all calls
+// have completed. Items are handed out one at a time so uneven work balances out - callers should
+// batch small items (e.g. rows into strips) so each call does a meaningful amount of work.
+void ParallelFor(uint32_t count, std::function<void(uint32_t)> func);
 };
 
-#define SCOPED_LOCK(cs) Threading::ScopedLock CONCAT(scopedlock, __LINE__)(&cs);
-#define SCOPED_LOCK_OPTIONAL(cs, cond) \
-  Threading::ScopedLock CONCAT(scopedlock, __LINE__)(cond ? &cs : NULL);
+#define DECLARE_LOCK_SITE() \
+  static Threading::LockSite CONCAT(locksite, __LINE__) = {__FILE__, __LINE__, 0, 0, 0, 0, NULL}
+
+#define SCOPED_LOCK(cs) \
+  DECLARE_LOCK_SITE();  \
+  Threading::ScopedLock CONCAT(scopedlock, __LINE__)(&cs, &CONCAT(locksite, __LINE__));
+#define SCOPED_LOCK_OPTIONAL(cs, cond)                                      \
+  DECLARE_LOCK_SITE();                                                      \
+  Threading::ScopedLock CONCAT(scopedlock, __LINE__)(cond ? &cs : NULL,     \
+                                                     &CONCAT(locksite, __LINE__));
 
-#define SCOPED_READLOCK(rw) Threading::ScopedReadLock CONCAT(scopedlock, __LINE__)(rw);
-#define SCOPED_WRITELOCK(rw) Threading::ScopedWriteLock CONCAT(scopedlock, __LINE__)(rw);
+#define SCOPED_READLOCK(rw) \
+  DECLARE_LOCK_SITE();      \
+  Threading::ScopedReadLock CONCAT(scopedlock, __LINE__)(rw, &CONCAT(locksite, __LINE__));
+#define SCOPED_WRITELOCK(rw) \
+  DECLARE_LOCK_SITE();       \
+  Threading::ScopedWriteLock CONCAT(scopedlock, __LINE__)(rw, &CONCAT(locksite, __LINE__));
 
-#define SCOPED_SPINLOCK(cs) Threading::ScopedSpinLock CONCAT(scopedlock, __LINE__)(cs);
+#define SCOPED_SPINLOCK(cs) \
+  DECLARE_LOCK_SITE();      \
+  Threading::ScopedSpinLock CONCAT(scopedlock, __LINE__)(cs, &CONCAT(locksite, __LINE__));
@@ -71,4 +71,113 @@ TEST_CASE("Test spin lock", "[threading]")
   CHECK(finalValue == value);
 }
 
+TEST_CASE("Test lock contention profiling", "[threading]")
+{
+  int csCounter = 0, spinCounter = 0;
+
+  Threading::CriticalSection cs;
+  Threading::SpinLock spin;
+
+  bool wasActive = Threading::IsLockProfilingActive();
+  Threading::EnableLockProfiling(true);
+
+  // discard anything recorded by earlier tests
+  Threading::ResetLockProfile();
+
+  rdcarray<Threading::ThreadHandle> threads;
+
+  for(int i = 0; i < 8; i++)
+  {
+    threads.push_back(Threading::CreateThread([&]() {
+      for(int c = 0; c < 1000; c++)
+      {
+        if(c & 1)
+        {
+          SCOPED_LOCK(cs);
+          csCounter++;
+        }
+        else
+        {
+          SCOPED_SPINLOCK(spin);
+          spinCounter++;
+        }
+      }
+    }));
+  }
+
+  for(Threading::ThreadHandle t : threads)
+  {
+    Threading::JoinThread(t);
+    Threading::CloseThread(t);
+  }
+
+  rdcarray<Threading::LockSite> sites = Threading::FetchLockProfile();
+
+  // other threads in the process may be taking locks elsewhere, only look at the sites above
+  rdcarray<Threading::LockSite> testSites;
+  for(const Threading::LockSite &site : sites)
+    if(!strcmp(site.file, __FILE__) && site.acquires > 0)
+      testSites.push_back(site);
+
+  REQUIRE(testSites.size() == 2);
+  CHECK(testSites[0].line != testSites[1].line);
+  for(const Threading::LockSite &site : testSites)
+  {
+    CHECK(site.acquires == 8 * 500);
+    CHECK(site.contended <= site.acquires);
+  }
+
+  // fetching resets the counters
+  sites = Threading::FetchLockProfile();
+  for(const Threading::LockSite &site : sites)
+  {
+    if(!strcmp(site.file, __FILE__))
+    {
+      CHECK(site.acquires == 0);
+      CHECK(site.contended == 0);
+      CHECK(site.waitTicks == 0);
+    }
+  }
+
+  Threading::EnableLockProfiling(wasActive);
+
+  CHECK(csCounter == 8 * 500);
+  CHECK(spinCounter == 8 * 500);
+
+  CHECK(spin.Trylock());
+  CHECK_FALSE(spin.Trylock());
+  spin.Unlock();
+  CHECK(spin.Trylock());
+  spin.Unlock();
+}
+
+TEST_CASE("Test parallel for", "[threading]")
+{
+  SECTION("Every item is visited exactly once")
+  {
+    rdcarray<int32_t> visits;
+    visits.resize(10000);
+
+    Threading::ParallelFor((uint32_t)visits.size(),
+                           [&](uint32_t i) { Atomic::Inc32(&visits[i]); });
+
+    for(size_t i = 0; i < visits.size(); i++)
+      CHECK(visits[i] == 1);
+  };
+
+  SECTION("Empty and single item ranges")
+  {
+    int32_t calls = 0;
+
+    Threading::ParallelFor(0, [&](uint32_t) { Atomic::Inc32(&calls); });
+    CHECK(calls == 0);
+
+    Threading::ParallelFor(1, [&](uint32_t i) {
+      CHECK(i == 0);
+      Atomic::Inc32(&calls);
+    });
+    CHECK(calls == 1);
+  };
+}
+
 #endif    // ENABLED(ENABLE_UNIT_TESTS)
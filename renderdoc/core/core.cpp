@@ -30,6 +30,7 @@
 #include "common/common.h"
 #include "common/threading.h"
 #include "core/settings.h"
+#include "core/tracing.h"
 #include "hooks/hooks.h"
 #include "maths/formatpacking.h"
 #include "replay/replay_driver.h"
@@ -51,6 +52,15 @@ extern "C" const rdcstr VulkanLayerJSONBasename = STRINGIZE(RDOC_BASE_NAME);
 RDOC_DEBUG_CONFIG(bool, Capture_Debug_SnapshotDiagnosticLog, false,
                   "Snapshot the diagnostic log at capture time and embed in the capture.");
 
+RDOC_DEBUG_CONFIG(bool, Capture_Debug_LockContentionProfiling, false,
+                  "Record time spent waiting on each SCOPED_LOCK site and log a report of the most "
+                  "contended locks after each capture is written.");
+
+RDOC_DEBUG_CONFIG(rdcstr, Replay_Debug_TracePath, "",
+                  "If set, profile regions in the replay are traced and written to this path as "
+                  "Chrome trace JSON when replay shuts down. Load it in chrome://tracing or the "
+                  "Perfetto UI.");
+
 // this is declared centrally so it can be shared with any backend - the name is a misnomer but kept
 // for backwards compatibility reasons.
 RDOC_CONFIG(rdcarray<rdcstr>, DXBC_Debug_SearchDirPaths, {},
@@ -530,6 +540,8 @@ void RenderDoc::Initialise()
     RDCLOGOUTPUT();
 
   ProcessConfig();
+
+  Threading::EnableLockProfiling(Capture_Debug_LockContentionProfiling());
 }
 
 RenderDoc::~RenderDoc()
@@ -630,6 +642,8 @@ void RenderDoc::InitialiseReplay(GlobalEnvironment env, const rdcarray<rdcstr> &
   else
     RecreateCrashHandler();
 
+  Tracing::Enable(!Replay_Debug_TracePath().empty());
+
   if(env.enumerateGPUs)
   {
     m_AvailableGPUThread = Threading::CreateThread([this]() {
@@ -878,6 +892,12 @@ void RenderDoc::ShutdownReplay()
 {
   SyncAvailableGPUThread();
 
+  if(Tracing::IsActive())
+  {
+    Tracing::Enable(false);
+    Tracing::WriteChromeTrace(Replay_Debug_TracePath());
+  }
+
   // call shutdown functions early, as we only want to do these in the RenderDoc destructor if we
   // have no other choice (i.e. we're capturing).
   for(auto it = m_ShutdownFunctions.begin(); it != m_ShutdownFunctions.end(); ++it)
@@ -2069,6 +2089,9 @@ void RenderDoc::FinishCaptureWriting(RDCFile *rdc, uint32_t frameNumber)
     RDCLOG("Discarded capture, Frame %u", frameNumber);
   }
 
+  if(Threading::IsLockProfilingActive())
+    Threading::DumpLockProfile();
+
   RenderDoc::Inst().SetProgress(CaptureProgress::FileWriting, 1.0f);
 }
 
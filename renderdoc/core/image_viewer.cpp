@@ -1064,12 +1064,9 @@ void ImageViewer::CreateProxyTexture(TextureDescription &texDetails, read_dds_da
           {
             for(uint32_t y = 0; y < mipheight; y++)
             {
-              for(uint32_t x = 0; x < mipwidth; x++)
-              {
-                *dst = DecodeFormattedComponents(texDetails.format, src);
-                dst++;
-                src += srcStride;
-              }
+              DecodeFormattedComponentsRow(texDetails.format, src, srcStride, mipwidth, dst);
+              dst += mipwidth;
+              src += srcStride * mipwidth;
             }
           }
         }
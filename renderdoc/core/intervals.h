@@ -157,12 +157,36 @@ public:
   inline Interval *operator->() { return &ref; }
 };
 
+// The sorted start points of an `Intervals<T>`, with bulk operations so that modifying many
+// intervals at once costs one pass over the array instead of an insert or erase per interval.
+template <typename T>
+struct IntervalStartPoints : public rdcsortedflatmap<uint64_t, T>
+{
+  using Point = rdcpair<uint64_t, T>;
+
+  // replace the `count` points starting at `idx` with `points`
+  void replace(size_t idx, size_t count, const rdcarray<Point> &points)
+  {
+    const size_t common = RDCMIN(count, points.size());
+    for(size_t i = 0; i < common; i++)
+      this->storage[idx + i] = points[i];
+
+    if(points.size() > count)
+      this->storage.insert(idx + common, points.data() + common, points.size() - common);
+    else if(count > points.size())
+      this->storage.erase(idx + common, count - common);
+  }
+
+  // replace all points. `points` is left with the old contents
+  void swap(rdcarray<Point> &points) { this->storage.swap(points); }
+};
+
 // Data structure to efficiently store values for disjoint intervals.
 template <typename T>
 struct Intervals
 {
 public:
-  using MapType = rdcsortedflatmap<uint64_t, T>;
+  using MapType = IntervalStartPoints<T>;
 
   typedef IntervalRef<T, MapType, typename MapType::iterator> interval;
   typedef IntervalsIter<T, MapType, typename MapType::iterator, interval> iterator;
@@ -215,32 +239,58 @@ public:
     if(finish <= start)
       return;
 
-    auto i = find(start);
+    // the intervals in [first, last) are the ones which intersect [start, finish)
+    const typename MapType::Point *points = StartPoints.begin();
+    const size_t count = StartPoints.size();
+    const size_t first = (StartPoints.upper_bound(start) - points) - 1;
+    const size_t last = StartPoints.lower_bound(finish) - points;
+
+    // build the replacement for [first, end) and splice it in once at the end
+    rdcarray<typename MapType::Point> repl;
+    repl.reserve(last - first + 2);
+    size_t end = last;
+
+    // the value an interval would be merged into, if it were added next
+    auto prevValue = [&]() -> const T * {
+      if(!repl.empty())
+        return &repl.back().second;
+      if(first > 0)
+        return &points[first - 1].second;
+      return NULL;
+    };
+
+    // the part of the first interval before `start` keeps its value
+    if(points[first].first < start)
+      repl.push_back(points[first]);
+
+    for(size_t i = first; i < last; i++)
+    {
+      T newValue = comp(points[i].second, val);
 
-    // Split the interval so that `i.start == start`
-    i->split(start);
+      // merge with the interval to the left if the values now match
+      const T *prev = prevValue();
+      if(prev && *prev == newValue)
+        continue;
 
-    // Loop over all the intervals in `a` that intersect the interval [start, finish)
-    for(; i != end() && i->start() < finish; i++)
-    {
-      if(i->finish() > finish)
-      {
-        // In this case, interval `i` extends beyond `finish`;
-        // split `i` so that we only update the portion of `i` in [start, finish).
-        i->split(finish);
+      repl.push_back({RDCMAX(points[i].first, start), newValue});
+    }
 
-        // `split` leaves `i` pointing at the interval starting at `finish`;
-        // move back to the interval finishing at `finish`.
-        i--;
-      }
-      i->setValue(comp(i->value(), val));
-      i->mergeLeft();
+    const uint64_t lastFinish = last < count ? points[last].first : UINT64_MAX;
+    const T *prev = prevValue();
+
+    if(finish < lastFinish)
+    {
+      // the part of the last interval after `finish` keeps its value
+      if(!prev || !(*prev == points[last - 1].second))
+        repl.push_back({finish, points[last - 1].second});
+    }
+    else if(last < count && prev && *prev == points[last].second)
+    {
+      // the following interval now matches the last updated interval, so merge them
+      end++;
     }
 
-    // `i` now points to the interval following the last interval whose value was
-    // modified; merge `i` with that last modified interval, if the values match.
-    if(i != end())
-      i->mergeLeft();
+    StartPoints.replace(first, end - first, repl);
   }
 
   // Update `this` by composing the value of each interval with the value of the
@@ -250,39 +300,40 @@ public:
   template <typename Compose>
   void merge(const Intervals &other, Compose comp)
   {
-    auto j = other.begin();
-    auto i = begin();
-
-    // Loop over the intervals in `this` (iterator `i`), while maintaining the
-    // interval `j` in `other` that contains `i`.
-    // The intervals in `this` are split as necessary, so that each `i` is
-    // contained in a single interval of `other`.
-    // Loop invariants:
-    //  * i.start() >= j.start()
-    //  * i.start() < j.end()
+    const typename MapType::Point *a = StartPoints.begin();
+    const typename MapType::Point *b = other.StartPoints.begin();
+    const size_t aCount = StartPoints.size();
+    const size_t bCount = other.StartPoints.size();
+
+    // walk both sets of intervals together, producing a new interval at every boundary in either
+    // of them, and build the result in a new array rather than splitting `this` in place.
+    rdcarray<typename MapType::Point> result;
+    result.reserve(aCount + bCount);
+
+    size_t i = 0, j = 0;
+    uint64_t pos = 0;
     while(true)
     {
-      if(i->finish() > j->finish())
-      {
-        i->split(j->finish());
-        i--;
-      }
+      const uint64_t aFinish = i + 1 < aCount ? a[i + 1].first : UINT64_MAX;
+      const uint64_t bFinish = j + 1 < bCount ? b[j + 1].first : UINT64_MAX;
+      const uint64_t finish = RDCMIN(aFinish, bFinish);
 
-      // Now i is contained in j, so we can update the value of all of i
-      i->setValue(comp(i->value(), j->value()));
+      T newValue = comp(a[i].second, b[j].second);
 
-      // The value of i and the interval left of i are now final;
-      // if these two intervals now have the same value, they can safely be
-      // merged into a single interval.
-      i->mergeLeft();
+      // merge with the interval to the left if the values match
+      if(result.empty() || !(result.back().second == newValue))
+        result.push_back({pos, newValue});
 
-      // Move to the next interval in `this`; also advance to the next interval
-      // in `other`, if necessary to maintain the invariant `i.start < j.end`.
-      i++;
-      if(i == end())
-        return;
-      if(i->start() >= j->finish())
+      if(finish == UINT64_MAX)
+        break;
+
+      pos = finish;
+      if(aFinish == finish)
+        i++;
+      if(bFinish == finish)
         j++;
     }
+
+    StartPoints.swap(result);
   }
 };
@@ -27,6 +27,7 @@
 #if ENABLED(ENABLE_UNIT_TESTS)
 
 #include "api/replay/rdcarray.h"
+#include "common/timing.h"
 #include "intervals.h"
 
 #include "catch/catch.hpp"
@@ -439,4 +440,105 @@ TEST_CASE("Test Intervals type", "[intervals]")
   };
 };
 
+// check the intervals against a reference value for every point in [0, 64], where the value at 64
+// covers [64, UINT64_MAX). Adjacent intervals should never have the same value.
+void check_reference(const Intervals<uint64_t> &value, const uint64_t *reference)
+{
+  for(uint64_t x = 0; x <= 64; x++)
+    CHECK(value.find(x)->value() == reference[x]);
+
+  for(auto i = value.begin(); i != value.end(); i++)
+  {
+    auto next = i;
+    next++;
+    if(next != value.end())
+    {
+      CHECK(i->finish() == next->start());
+      CHECK(!(i->value() == next->value()));
+    }
+  }
+}
+
+void random_update(Intervals<uint64_t> &test, uint64_t *reference)
+{
+  uint64_t start = rand() % 65;
+  uint64_t finish = start + rand() % 20;
+  if(finish > 64)
+    finish = UINT64_MAX;
+  uint64_t val = rand() % 3;
+
+  auto comp = [](uint64_t x, uint64_t y) -> uint64_t { return (x + y) % 4; };
+
+  test.update(start, finish, val, comp);
+  for(uint64_t x = start; x < RDCMIN(finish, (uint64_t)65); x++)
+    reference[x] = comp(reference[x], val);
+}
+
+TEST_CASE("Test Intervals against a reference", "[intervals]")
+{
+  for(int iter = 0; iter < 200; iter++)
+  {
+    Intervals<uint64_t> test, other;
+    uint64_t reference[65] = {}, otherReference[65] = {};
+
+    for(int u = 0; u < 20; u++)
+    {
+      random_update(test, reference);
+      check_reference(test, reference);
+
+      random_update(other, otherReference);
+      check_reference(other, otherReference);
+    }
+
+    auto comp = [](uint64_t x, uint64_t y) -> uint64_t { return RDCMAX(x, y); };
+
+    test.merge(other, comp);
+    for(uint64_t x = 0; x <= 64; x++)
+      reference[x] = comp(reference[x], otherReference[x]);
+    check_reference(test, reference);
+  }
+}
+
+TEST_CASE("Benchmark Intervals with sub-allocations", "[.][intervals][benchmark]")
+{
+  // a single large memory allocation with many sub-allocations bound into it, as apps with their
+  // own memory allocator do. Offsets are 256-byte aligned and the sizes vary a lot.
+  const uint64_t numAllocs = 50000;
+
+  rdcarray<rdcpair<uint64_t, uint64_t>> allocs;
+  uint64_t offset = 0;
+  for(uint64_t i = 0; i < numAllocs; i++)
+  {
+    uint64_t size = AlignUp((uint64_t)(rand() % 4096) * ((rand() % 8) == 0 ? 1024 : 16), (uint64_t)256);
+    size = RDCMAX(size, (uint64_t)256);
+    allocs.push_back({offset, size});
+    // leave some gaps for padding/freed allocations
+    offset += size + ((rand() % 4) == 0 ? 256 : 0);
+  }
+
+  // resources are referenced in a different order to their placement
+  for(size_t i = allocs.size() - 1; i > 0; i--)
+    std::swap(allocs[i], allocs[rand() % (i + 1)]);
+
+  auto comp = [](uint64_t x, uint64_t y) -> uint64_t { return RDCMAX(x, y); };
+
+  Intervals<uint64_t> memRefs, frameRefs;
+
+  PerformanceTimer timer;
+  for(size_t i = 0; i < allocs.size(); i++)
+    memRefs.update(allocs[i].first, allocs[i].first + allocs[i].second, 1 + (i % 3), comp);
+  double updateTime = timer.GetMilliseconds();
+
+  for(size_t i = 0; i < allocs.size(); i += 2)
+    frameRefs.update(allocs[i].first, allocs[i].first + allocs[i].second, 2 + (i % 5), comp);
+
+  timer.Restart();
+  memRefs.merge(frameRefs, comp);
+  double mergeTime = timer.GetMilliseconds();
+
+  RDCLOG("%u sub-allocations: %u intervals, update %.2f ms, merge with %u intervals %.2f ms",
+         (uint32_t)numAllocs, (uint32_t)memRefs.size(), updateTime, (uint32_t)frameRefs.size(),
+         mergeTime);
+}
+
 #endif    // ENABLED(ENABLE_UNIT_TESTS)
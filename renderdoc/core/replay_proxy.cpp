@@ -1492,7 +1492,10 @@ void ReplayProxy::Proxied_ReplaceResource(ParamSerialiser &paramser, ReturnSeria
   }
 
   if(paramser.IsWriting())
+  {
     m_LiveIDs.clear();
+    m_PrefetchValid = false;
+  }
 
   SERIALISE_RETURN_VOID();
 }
@@ -1522,7 +1525,10 @@ void ReplayProxy::Proxied_RemoveReplacement(ParamSerialiser &paramser, ReturnSer
   }
 
   if(paramser.IsWriting())
+  {
     m_LiveIDs.clear();
+    m_PrefetchValid = false;
+  }
 
   SERIALISE_RETURN_VOID();
 }
@@ -1746,10 +1752,122 @@ void ReplayProxy::FreeDebugger(ShaderDebugger *debugger)
   PROXY_FUNCTION(FreeDebugger, debugger);
 }
 
+template <typename SerialiserType>
+void ReplayProxy::SerialisePipelineState(SerialiserType &ser, D3D11Pipe::State *d3d11,
+                                         D3D12Pipe::State *d3d12, GLPipe::State *gl,
+                                         VKPipe::State *vk)
+{
+  if(m_APIProps.pipelineType == GraphicsAPI::D3D11)
+  {
+    SERIALISE_ELEMENT(*d3d11);
+  }
+  else if(m_APIProps.pipelineType == GraphicsAPI::D3D12)
+  {
+    SERIALISE_ELEMENT(*d3d12);
+  }
+  else if(m_APIProps.pipelineType == GraphicsAPI::OpenGL)
+  {
+    SERIALISE_ELEMENT(*gl);
+  }
+  else if(m_APIProps.pipelineType == GraphicsAPI::Vulkan)
+  {
+    SERIALISE_ELEMENT(*vk);
+  }
+}
+
+void ReplayProxy::FetchShaderReflections()
+{
+  if(m_APIProps.pipelineType == GraphicsAPI::D3D11 && m_D3D11PipelineState)
+  {
+    D3D11Pipe::Shader *stages[] = {
+        &m_D3D11PipelineState->vertexShader, &m_D3D11PipelineState->hullShader,
+        &m_D3D11PipelineState->domainShader, &m_D3D11PipelineState->geometryShader,
+        &m_D3D11PipelineState->pixelShader,  &m_D3D11PipelineState->computeShader,
+    };
+
+    for(size_t i = 0; i < ARRAY_COUNT(stages); i++)
+      if(stages[i]->resourceId != ResourceId())
+        stages[i]->reflection =
+            GetShader(ResourceId(), GetLiveID(stages[i]->resourceId), ShaderEntryPoint());
+
+    if(m_D3D11PipelineState->inputAssembly.resourceId != ResourceId())
+      m_D3D11PipelineState->inputAssembly.bytecode =
+          GetShader(ResourceId(), GetLiveID(m_D3D11PipelineState->inputAssembly.resourceId),
+                    ShaderEntryPoint());
+  }
+  else if(m_APIProps.pipelineType == GraphicsAPI::D3D12 && m_D3D12PipelineState)
+  {
+    D3D12Pipe::Shader *stages[] = {
+        &m_D3D12PipelineState->vertexShader, &m_D3D12PipelineState->hullShader,
+        &m_D3D12PipelineState->domainShader, &m_D3D12PipelineState->geometryShader,
+        &m_D3D12PipelineState->pixelShader,  &m_D3D12PipelineState->computeShader,
+        &m_D3D12PipelineState->ampShader,    &m_D3D12PipelineState->meshShader,
+    };
+
+    ResourceId pipe = GetLiveID(m_D3D12PipelineState->pipelineResourceId);
+
+    for(size_t i = 0; i < ARRAY_COUNT(stages); i++)
+      if(stages[i]->resourceId != ResourceId())
+        stages[i]->reflection =
+            GetShader(pipe, GetLiveID(stages[i]->resourceId), ShaderEntryPoint());
+  }
+  else if(m_APIProps.pipelineType == GraphicsAPI::OpenGL && m_GLPipelineState)
+  {
+    GLPipe::Shader *stages[] = {
+        &m_GLPipelineState->vertexShader,   &m_GLPipelineState->tessControlShader,
+        &m_GLPipelineState->tessEvalShader, &m_GLPipelineState->geometryShader,
+        &m_GLPipelineState->fragmentShader, &m_GLPipelineState->computeShader,
+    };
+
+    for(size_t i = 0; i < ARRAY_COUNT(stages); i++)
+      if(stages[i]->shaderResourceId != ResourceId())
+        stages[i]->reflection =
+            GetShader(ResourceId(), GetLiveID(stages[i]->shaderResourceId), ShaderEntryPoint());
+  }
+  else if(m_APIProps.pipelineType == GraphicsAPI::Vulkan && m_VulkanPipelineState)
+  {
+    VKPipe::Shader *stages[] = {
+        &m_VulkanPipelineState->vertexShader,   &m_VulkanPipelineState->tessControlShader,
+        &m_VulkanPipelineState->tessEvalShader, &m_VulkanPipelineState->geometryShader,
+        &m_VulkanPipelineState->fragmentShader, &m_VulkanPipelineState->computeShader,
+        &m_VulkanPipelineState->taskShader,     &m_VulkanPipelineState->meshShader,
+    };
+
+    ResourceId pipe = GetLiveID(m_VulkanPipelineState->graphics.pipelineResourceId);
+
+    for(size_t i = 0; i < ARRAY_COUNT(stages); i++)
+    {
+      if(i == 5)
+        pipe = GetLiveID(m_VulkanPipelineState->compute.pipelineResourceId);
+
+      if(stages[i]->resourceId != ResourceId())
+        stages[i]->reflection =
+            GetShader(pipe, GetLiveID(stages[i]->resourceId),
+                      ShaderEntryPoint(stages[i]->entryPoint, stages[i]->stage));
+    }
+  }
+}
+
 template <typename ParamSerialiser, typename ReturnSerialiser>
 void ReplayProxy::Proxied_SavePipelineState(ParamSerialiser &paramser, ReturnSerialiser &retser,
                                             uint32_t eventId)
 {
+  // if the state was sent along with the replay to this event, use it without a round trip
+  if(paramser.IsWriting() && m_PrefetchValid && m_PrefetchEventID == eventId)
+  {
+    if(m_APIProps.pipelineType == GraphicsAPI::D3D11)
+      *m_D3D11PipelineState = m_PrefetchD3D11PipelineState;
+    else if(m_APIProps.pipelineType == GraphicsAPI::D3D12)
+      *m_D3D12PipelineState = m_PrefetchD3D12PipelineState;
+    else if(m_APIProps.pipelineType == GraphicsAPI::OpenGL)
+      *m_GLPipelineState = m_PrefetchGLPipelineState;
+    else if(m_APIProps.pipelineType == GraphicsAPI::Vulkan)
+      *m_VulkanPipelineState = m_PrefetchVulkanPipelineState;
+
+    FetchShaderReflections();
+    return;
+  }
+
   const ReplayProxyPacket expectedPacket = eReplayProxy_SavePipelineState;
   ReplayProxyPacket packet = eReplayProxy_SavePipelineState;
 
@@ -1770,97 +1888,13 @@ void ReplayProxy::Proxied_SavePipelineState(ParamSerialiser &paramser, ReturnSer
   {
     ReturnSerialiser &ser = retser;
     PACKET_HEADER(packet);
-    if(m_APIProps.pipelineType == GraphicsAPI::D3D11)
-    {
-      SERIALISE_ELEMENT(*m_D3D11PipelineState);
-    }
-    else if(m_APIProps.pipelineType == GraphicsAPI::D3D12)
-    {
-      SERIALISE_ELEMENT(*m_D3D12PipelineState);
-    }
-    else if(m_APIProps.pipelineType == GraphicsAPI::OpenGL)
-    {
-      SERIALISE_ELEMENT(*m_GLPipelineState);
-    }
-    else if(m_APIProps.pipelineType == GraphicsAPI::Vulkan)
-    {
-      SERIALISE_ELEMENT(*m_VulkanPipelineState);
-    }
+    SerialisePipelineState(ser, m_D3D11PipelineState, m_D3D12PipelineState, m_GLPipelineState,
+                           m_VulkanPipelineState);
     SERIALISE_ELEMENT(packet);
     ser.EndChunk();
 
     if(retser.IsReading())
-    {
-      if(m_APIProps.pipelineType == GraphicsAPI::D3D11 && m_D3D11PipelineState)
-      {
-        D3D11Pipe::Shader *stages[] = {
-            &m_D3D11PipelineState->vertexShader, &m_D3D11PipelineState->hullShader,
-            &m_D3D11PipelineState->domainShader, &m_D3D11PipelineState->geometryShader,
-            &m_D3D11PipelineState->pixelShader,  &m_D3D11PipelineState->computeShader,
-        };
-
-        for(size_t i = 0; i < ARRAY_COUNT(stages); i++)
-          if(stages[i]->resourceId != ResourceId())
-            stages[i]->reflection =
-                GetShader(ResourceId(), GetLiveID(stages[i]->resourceId), ShaderEntryPoint());
-
-        if(m_D3D11PipelineState->inputAssembly.resourceId != ResourceId())
-          m_D3D11PipelineState->inputAssembly.bytecode =
-              GetShader(ResourceId(), GetLiveID(m_D3D11PipelineState->inputAssembly.resourceId),
-                        ShaderEntryPoint());
-      }
-      else if(m_APIProps.pipelineType == GraphicsAPI::D3D12 && m_D3D12PipelineState)
-      {
-        D3D12Pipe::Shader *stages[] = {
-            &m_D3D12PipelineState->vertexShader, &m_D3D12PipelineState->hullShader,
-            &m_D3D12PipelineState->domainShader, &m_D3D12PipelineState->geometryShader,
-            &m_D3D12PipelineState->pixelShader,  &m_D3D12PipelineState->computeShader,
-            &m_D3D12PipelineState->ampShader,    &m_D3D12PipelineState->meshShader,
-        };
-
-        ResourceId pipe = GetLiveID(m_D3D12PipelineState->pipelineResourceId);
-
-        for(size_t i = 0; i < ARRAY_COUNT(stages); i++)
-          if(stages[i]->resourceId != ResourceId())
-            stages[i]->reflection =
-                GetShader(pipe, GetLiveID(stages[i]->resourceId), ShaderEntryPoint());
-      }
-      else if(m_APIProps.pipelineType == GraphicsAPI::OpenGL && m_GLPipelineState)
-      {
-        GLPipe::Shader *stages[] = {
-            &m_GLPipelineState->vertexShader,   &m_GLPipelineState->tessControlShader,
-            &m_GLPipelineState->tessEvalShader, &m_GLPipelineState->geometryShader,
-            &m_GLPipelineState->fragmentShader, &m_GLPipelineState->computeShader,
-        };
-
-        for(size_t i = 0; i < ARRAY_COUNT(stages); i++)
-          if(stages[i]->shaderResourceId != ResourceId())
-            stages[i]->reflection =
-                GetShader(ResourceId(), GetLiveID(stages[i]->shaderResourceId), ShaderEntryPoint());
-      }
-      else if(m_APIProps.pipelineType == GraphicsAPI::Vulkan && m_VulkanPipelineState)
-      {
-        VKPipe::Shader *stages[] = {
-            &m_VulkanPipelineState->vertexShader,   &m_VulkanPipelineState->tessControlShader,
-            &m_VulkanPipelineState->tessEvalShader, &m_VulkanPipelineState->geometryShader,
-            &m_VulkanPipelineState->fragmentShader, &m_VulkanPipelineState->computeShader,
-            &m_VulkanPipelineState->taskShader,     &m_VulkanPipelineState->meshShader,
-        };
-
-        ResourceId pipe = GetLiveID(m_VulkanPipelineState->graphics.pipelineResourceId);
-
-        for(size_t i = 0; i < ARRAY_COUNT(stages); i++)
-        {
-          if(i == 5)
-            pipe = GetLiveID(m_VulkanPipelineState->compute.pipelineResourceId);
-
-          if(stages[i]->resourceId != ResourceId())
-            stages[i]->reflection =
-                GetShader(pipe, GetLiveID(stages[i]->resourceId),
-                          ShaderEntryPoint(stages[i]->entryPoint, stages[i]->stage));
-        }
-      }
-    }
+      FetchShaderReflections();
   }
 
   CheckError(packet, expectedPacket);
@@ -1877,6 +1911,13 @@ rdcarray<Descriptor> ReplayProxy::Proxied_GetDescriptors(ParamSerialiser &params
                                                          ResourceId descriptorStore,
                                                          const rdcarray<DescriptorRange> &ranges)
 {
+  if(paramser.IsWriting())
+  {
+    const PrefetchedDescriptors *prefetch = FindPrefetchedDescriptors(descriptorStore, ranges);
+    if(prefetch)
+      return prefetch->descriptors;
+  }
+
   const ReplayProxyPacket expectedPacket = eReplayProxy_GetDescriptors;
   ReplayProxyPacket packet = eReplayProxy_GetDescriptors;
   rdcarray<Descriptor> ret;
@@ -1910,6 +1951,13 @@ rdcarray<SamplerDescriptor> ReplayProxy::Proxied_GetSamplerDescriptors(
     ParamSerialiser &paramser, ReturnSerialiser &retser, ResourceId descriptorStore,
     const rdcarray<DescriptorRange> &ranges)
 {
+  if(paramser.IsWriting())
+  {
+    const PrefetchedDescriptors *prefetch = FindPrefetchedDescriptors(descriptorStore, ranges);
+    if(prefetch)
+      return prefetch->samplerDescriptors;
+  }
+
   const ReplayProxyPacket expectedPacket = eReplayProxy_GetSamplerDescriptors;
   ReplayProxyPacket packet = eReplayProxy_GetSamplerDescriptors;
   rdcarray<SamplerDescriptor> ret;
@@ -1943,6 +1991,9 @@ rdcarray<DescriptorAccess> ReplayProxy::Proxied_GetDescriptorAccess(ParamSeriali
                                                                     ReturnSerialiser &retser,
                                                                     uint32_t eventId)
 {
+  if(paramser.IsWriting() && m_PrefetchValid && m_PrefetchEventID == eventId)
+    return m_PrefetchDescriptorAccess;
+
   const ReplayProxyPacket expectedPacket = eReplayProxy_GetDescriptorAccess;
   ReplayProxyPacket packet = eReplayProxy_GetDescriptorAccess;
   rdcarray<DescriptorAccess> ret;
@@ -2009,17 +2060,51 @@ void ReplayProxy::Proxied_ReplayLog(ParamSerialiser &paramser, ReturnSerialiser
   const ReplayProxyPacket expectedPacket = eReplayProxy_ReplayLog;
   ReplayProxyPacket packet = eReplayProxy_ReplayLog;
 
+  // the first time we replay to draw an event, ask for the state that will be fetched next to be
+  // sent back along with the replay instead of making a round trip for each query. Repeated replays
+  // to the same event (e.g. for overlays) leave the previous state in place.
+  bool prefetch = false;
+  if(paramser.IsWriting())
+    prefetch = replayType == eReplay_OnlyDraw &&
+               (!m_PrefetchValid || m_PrefetchEventID != endEventID);
+
   {
     BEGIN_PARAMS();
     SERIALISE_ELEMENT(endEventID);
     SERIALISE_ELEMENT(replayType);
+    SERIALISE_ELEMENT(prefetch);
     END_PARAMS();
   }
 
+  rdcarray<DescriptorAccess> access;
+  rdcarray<ResourceId> liveStores;
+  rdcarray<Descriptor> descs;
+  rdcarray<SamplerDescriptor> samps;
+
   {
     REMOTE_EXECUTION();
     if(paramser.IsReading() && !paramser.IsErrored() && !m_IsErrored)
+    {
       m_Remote->ReplayLog(endEventID, replayType);
+
+      if(prefetch)
+      {
+        m_Remote->SavePipelineState(endEventID);
+        access = m_Remote->GetDescriptorAccess(endEventID);
+
+        for(const DescriptorAccessRanges &group : CollateDescriptorAccess(access))
+        {
+          ResourceId store = m_Remote->GetLiveID(group.descriptorStore);
+          liveStores.push_back(store);
+
+          if(store != ResourceId())
+          {
+            descs.append(m_Remote->GetDescriptors(store, group.ranges));
+            samps.append(m_Remote->GetSamplerDescriptors(store, group.ranges));
+          }
+        }
+      }
+    }
   }
 
   if(retser.IsReading())
@@ -2030,9 +2115,117 @@ void ReplayProxy::Proxied_ReplayLog(ParamSerialiser &paramser, ReturnSerialiser
 
   m_EventID = endEventID;
 
+  // the prefetched data is sent as the replies that the individual queries would have returned
+  if(prefetch)
+  {
+    {
+      ReturnSerialiser &ser = retser;
+      PACKET_HEADER(eReplayProxy_SavePipelineState);
+      if(ser.IsReading())
+        SerialisePipelineState(ser, &m_PrefetchD3D11PipelineState, &m_PrefetchD3D12PipelineState,
+                               &m_PrefetchGLPipelineState, &m_PrefetchVulkanPipelineState);
+      else
+        SerialisePipelineState(ser, m_D3D11PipelineState, m_D3D12PipelineState,
+                               m_GLPipelineState, m_VulkanPipelineState);
+      ser.EndChunk();
+    }
+
+    {
+      ReturnSerialiser &ser = retser;
+      PACKET_HEADER(eReplayProxy_GetDescriptorAccess);
+      SERIALISE_ELEMENT(access);
+      ser.EndChunk();
+    }
+
+    {
+      ReturnSerialiser &ser = retser;
+      PACKET_HEADER(eReplayProxy_GetLiveID);
+      SERIALISE_ELEMENT(liveStores);
+      ser.EndChunk();
+    }
+
+    {
+      ReturnSerialiser &ser = retser;
+      PACKET_HEADER(eReplayProxy_GetDescriptors);
+      SERIALISE_ELEMENT(descs);
+      ser.EndChunk();
+    }
+
+    {
+      ReturnSerialiser &ser = retser;
+      PACKET_HEADER(eReplayProxy_GetSamplerDescriptors);
+      SERIALISE_ELEMENT(samps);
+      ser.EndChunk();
+    }
+  }
+
+  if(retser.IsReading())
+  {
+    if(prefetch && !retser.IsErrored() && !m_IsErrored)
+      StorePrefetch(endEventID, access, liveStores, descs, samps);
+    else if(prefetch || m_PrefetchEventID != endEventID)
+      m_PrefetchValid = false;
+  }
+
   SERIALISE_RETURN_VOID();
 }
 
+void ReplayProxy::StorePrefetch(uint32_t eventId, const rdcarray<DescriptorAccess> &access,
+                                const rdcarray<ResourceId> &liveStores,
+                                const rdcarray<Descriptor> &descs,
+                                const rdcarray<SamplerDescriptor> &samps)
+{
+  m_PrefetchValid = false;
+  m_PrefetchEventID = eventId;
+  m_PrefetchDescriptorAccess = access;
+  m_PrefetchDescriptors.clear();
+
+  rdcarray<DescriptorAccessRanges> groups = CollateDescriptorAccess(access);
+
+  if(groups.size() != liveStores.size())
+    return;
+
+  size_t idx = 0;
+  for(size_t i = 0; i < groups.size(); i++)
+  {
+    m_LiveIDs[groups[i].descriptorStore] = liveStores[i];
+
+    if(liveStores[i] == ResourceId())
+      continue;
+
+    size_t count = 0;
+    for(const DescriptorRange &range : groups[i].ranges)
+      count += range.count;
+
+    if(idx + count > descs.size() || idx + count > samps.size())
+      return;
+
+    PrefetchedDescriptors prefetch;
+    prefetch.descriptorStore = liveStores[i];
+    prefetch.ranges = groups[i].ranges;
+    prefetch.descriptors.assign(descs.data() + idx, count);
+    prefetch.samplerDescriptors.assign(samps.data() + idx, count);
+    m_PrefetchDescriptors.push_back(std::move(prefetch));
+
+    idx += count;
+  }
+
+  m_PrefetchValid = true;
+}
+
+const ReplayProxy::PrefetchedDescriptors *ReplayProxy::FindPrefetchedDescriptors(
+    ResourceId descriptorStore, const rdcarray<DescriptorRange> &ranges)
+{
+  if(!m_PrefetchValid || m_PrefetchEventID != m_EventID)
+    return NULL;
+
+  for(const PrefetchedDescriptors &prefetch : m_PrefetchDescriptors)
+    if(prefetch.descriptorStore == descriptorStore && prefetch.ranges == ranges)
+      return &prefetch;
+
+  return NULL;
+}
+
 void ReplayProxy::ReplayLog(uint32_t endEventID, ReplayLogType replayType)
 {
   PROXY_FUNCTION(ReplayLog, endEventID, replayType);
@@ -657,6 +657,37 @@ private:
 
   std::map<ResourceId, ResourceId> m_LiveIDs;
 
+  // this cache only exists on the client side. When replaying to a new event for display, the
+  // remote server sends back the pipeline state and accessed descriptors in the same reply, so
+  // that fetching the pipeline state afterwards doesn't need a round trip for every query. It's
+  // valid until we replay to a different event or change any replacements.
+  struct PrefetchedDescriptors
+  {
+    ResourceId descriptorStore;
+    rdcarray<DescriptorRange> ranges;
+    rdcarray<Descriptor> descriptors;
+    rdcarray<SamplerDescriptor> samplerDescriptors;
+  };
+
+  bool m_PrefetchValid = false;
+  uint32_t m_PrefetchEventID = 0;
+  D3D11Pipe::State m_PrefetchD3D11PipelineState;
+  D3D12Pipe::State m_PrefetchD3D12PipelineState;
+  GLPipe::State m_PrefetchGLPipelineState;
+  VKPipe::State m_PrefetchVulkanPipelineState;
+  rdcarray<DescriptorAccess> m_PrefetchDescriptorAccess;
+  rdcarray<PrefetchedDescriptors> m_PrefetchDescriptors;
+
+  template <typename SerialiserType>
+  void SerialisePipelineState(SerialiserType &ser, D3D11Pipe::State *d3d11,
+                              D3D12Pipe::State *d3d12, GLPipe::State *gl, VKPipe::State *vk);
+  void FetchShaderReflections();
+  void StorePrefetch(uint32_t eventId, const rdcarray<DescriptorAccess> &access,
+                     const rdcarray<ResourceId> &liveStores, const rdcarray<Descriptor> &descs,
+                     const rdcarray<SamplerDescriptor> &samps);
+  const PrefetchedDescriptors *FindPrefetchedDescriptors(ResourceId descriptorStore,
+                                                         const rdcarray<DescriptorRange> &ranges);
+
   struct ShaderReflKey
   {
     ShaderReflKey() {}
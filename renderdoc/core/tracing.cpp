@@ -0,0 +1,412 @@
+/******************************************************************************
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019-2024 Baldur Karlsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+
+#include "tracing.h"
+#include "api/replay/renderdoc_replay.h"
+#include "common/common.h"
+#include "common/threading.h"
+#include "common/timing.h"
+#include "serialise/serialiser.h"
+#include "strings/string_utils.h"
+
+namespace Tracing
+{
+int32_t TracingActive = 0;
+
+struct TraceEvent
+{
+  // NULL for the end of a region
+  const char *name;
+  uint64_t tick;
+};
+
+struct ThreadTrace
+{
+  static const uint32_t Capacity = 64 * 1024;
+  RDCCOMPILE_ASSERT((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+  uint64_t threadId = 0;
+  // total number of events ever written. Only the owning thread writes this, other threads read it
+  // to know how much of the ring is valid.
+  int32_t written = 0;
+  // events before this have been discarded by Reset(). Protected by GetLock()
+  uint32_t readStart = 0;
+  TraceEvent events[Capacity];
+};
+
+static uint64_t threadTraceSlot = 0;
+
+static Threading::CriticalSection &GetLock()
+{
+  static Threading::CriticalSection lock;
+  return lock;
+}
+
+// protected by GetLock(). Buffers are never freed as threads may still be writing to them
+static rdcarray<ThreadTrace *> &GetThreadTraces()
+{
+  static rdcarray<ThreadTrace *> traces;
+  return traces;
+}
+
+// protected by GetLock()
+static StringDatabase &GetNames()
+{
+  static StringDatabase names;
+  return names;
+}
+
+static ThreadTrace *GetThreadTrace()
+{
+  ThreadTrace *trace = (ThreadTrace *)Threading::GetTLSValue(threadTraceSlot);
+
+  if(trace == NULL)
+  {
+    trace = new ThreadTrace;
+    trace->threadId = Threading::GetCurrentID();
+
+    {
+      SCOPED_LOCK(GetLock());
+      GetThreadTraces().push_back(trace);
+    }
+
+    Threading::SetTLSValue(threadTraceSlot, trace);
+  }
+
+  return trace;
+}
+
+static void Record(const char *name)
+{
+  ThreadTrace *trace = GetThreadTrace();
+
+  uint32_t idx = (uint32_t)trace->written;
+  TraceEvent &ev = trace->events[idx & (ThreadTrace::Capacity - 1)];
+  ev.name = name;
+  ev.tick = Timing::GetTick();
+
+  // publish the event
+  Atomic::Inc32(&trace->written);
+}
+
+void Enable(bool enable)
+{
+  if(enable)
+  {
+    SCOPED_LOCK(GetLock());
+    if(threadTraceSlot == 0)
+      threadTraceSlot = Threading::AllocateTLSSlot();
+  }
+
+  int32_t prev = Atomic::Exch32(&TracingActive, enable ? 1 : 0);
+
+  if(prev == 0 && enable)
+    RDCLOG("Tracing profile regions");
+}
+
+void BeginRegion(const char *name)
+{
+  if(IsActive())
+    Record(name ? name : "");
+}
+
+void BeginRegion(const rdcstr &name)
+{
+  if(!IsActive())
+    return;
+
+  const char *interned;
+  {
+    SCOPED_LOCK(GetLock());
+    interned = GetNames().Intern(name);
+  }
+
+  Record(interned);
+}
+
+void EndRegion()
+{
+  if(IsActive())
+    Record(NULL);
+}
+
+void Reset()
+{
+  SCOPED_LOCK(GetLock());
+
+  // we can't safely reset a thread's write position while it may be writing, so instead skip
+  // everything recorded up to now.
+  for(ThreadTrace *trace : GetThreadTraces())
+    trace->readStart = (uint32_t)Atomic::Load32(&trace->written);
+}
+
+// the range of valid events in a thread's ring, [start, end)
+static rdcpair<uint32_t, uint32_t> GetValidRange(ThreadTrace *trace)
+{
+  uint32_t end = (uint32_t)Atomic::Load32(&trace->written);
+  uint32_t start = end > ThreadTrace::Capacity ? end - ThreadTrace::Capacity : 0;
+  return {RDCMAX(start, trace->readStart), end};
+}
+
+static void AppendEscaped(rdcstr &json, const char *str)
+{
+  for(; *str; str++)
+  {
+    const char c = *str;
+    if(c == '"' || c == '\\')
+    {
+      json.push_back('\\');
+      json.push_back(c);
+    }
+    else if((unsigned char)c < 0x20)
+    {
+      json += StringFormat::Fmt("\\u%04x", (uint32_t)(unsigned char)c);
+    }
+    else
+    {
+      json.push_back(c);
+    }
+  }
+}
+
+rdcstr GetChromeTrace()
+{
+  rdcstr json = "{\"traceEvents\":[\n";
+
+  const double ticksToMicroseconds = 1000.0 / Timing::GetTickFrequency();
+  const uint32_t pid = Process::GetCurrentPID();
+  bool first = true;
+
+  SCOPED_LOCK(GetLock());
+
+  uint64_t baseTick = UINT64_MAX;
+  for(ThreadTrace *trace : GetThreadTraces())
+  {
+    rdcpair<uint32_t, uint32_t> range = GetValidRange(trace);
+    if(range.first < range.second)
+      baseTick = RDCMIN(baseTick, trace->events[range.first & (ThreadTrace::Capacity - 1)].tick);
+  }
+
+  for(ThreadTrace *trace : GetThreadTraces())
+  {
+    rdcpair<uint32_t, uint32_t> range = GetValidRange(trace);
+
+    // if the oldest events were overwritten, skip any ends that no longer have a begin
+    uint32_t depth = 0;
+
+    for(uint32_t i = range.first; i < range.second; i++)
+    {
+      const TraceEvent &ev = trace->events[i & (ThreadTrace::Capacity - 1)];
+
+      if(ev.name == NULL)
+      {
+        if(depth == 0)
+          continue;
+        depth--;
+      }
+      else
+      {
+        depth++;
+      }
+
+      if(!first)
+        json += ",\n";
+      first = false;
+
+      json += StringFormat::Fmt("{\"ph\":\"%c\",\"pid\":%u,\"tid\":%llu,\"ts\":%.3f",
+                                ev.name ? 'B' : 'E', pid, trace->threadId,
+                                double(ev.tick - baseTick) * ticksToMicroseconds);
+
+      if(ev.name)
+      {
+        json += ",\"name\":\"";
+        AppendEscaped(json, ev.name);
+        json += "\"";
+      }
+
+      json += "}";
+    }
+  }
+
+  json += "\n]}\n";
+
+  return json;
+}
+
+bool WriteChromeTrace(const rdcstr &filename)
+{
+  rdcstr json = GetChromeTrace();
+
+  if(!FileIO::WriteAll(filename, json.c_str(), json.size()))
+  {
+    RDCERR("Couldn't write trace to %s: %s", filename.c_str(), FileIO::ErrorString().c_str());
+    return false;
+  }
+
+  RDCLOG("Wrote profile region trace to %s", filename.c_str());
+  return true;
+}
+};
+
+#if ENABLED(ENABLE_UNIT_TESTS)
+
+#include "catch/catch.hpp"
+
+static int CountOccurrences(const rdcstr &haystack, const rdcstr &needle)
+{
+  int ret = 0;
+  int32_t offs = haystack.find(needle);
+  while(offs >= 0)
+  {
+    ret++;
+    offs = haystack.find(needle, offs + 1);
+  }
+  return ret;
+}
+
+TEST_CASE("Test profile region tracing", "[tracing]")
+{
+  Tracing::Enable(true);
+  Tracing::Reset();
+
+  SECTION("Nested regions on multiple threads")
+  {
+    Tracing::BeginRegion("Outer");
+    Tracing::BeginRegion(rdcstr("Dynamic ") + "name");
+    Tracing::EndRegion();
+
+    Threading::ThreadHandle th = Threading::CreateThread([]() {
+      Tracing::BeginRegion("Other thread");
+      Tracing::EndRegion();
+    });
+    Threading::JoinThread(th);
+    Threading::CloseThread(th);
+
+    Tracing::EndRegion();
+
+    rdcstr json = Tracing::GetChromeTrace();
+
+    CHECK(json.beginsWith("{\"traceEvents\":["));
+    CHECK(CountOccurrences(json, "\"ph\":\"B\"") == 3);
+    CHECK(CountOccurrences(json, "\"ph\":\"E\"") == 3);
+    CHECK(json.contains("\"name\":\"Outer\""));
+    CHECK(json.contains("\"name\":\"Dynamic name\""));
+    CHECK(json.contains("\"name\":\"Other thread\""));
+    CHECK(CountOccurrences(json, StringFormat::Fmt("\"tid\":%llu", Threading::GetCurrentID())) == 4);
+  };
+
+  SECTION("Names are escaped")
+  {
+    Tracing::BeginRegion("quote\" backslash\\ newline\n");
+    Tracing::EndRegion();
+
+    rdcstr json = Tracing::GetChromeTrace();
+
+    CHECK(json.contains("\"name\":\"quote\\\" backslash\\\\ newline\\u000a\""));
+  };
+
+  SECTION("Reset discards events")
+  {
+    Tracing::BeginRegion("Discarded");
+    Tracing::EndRegion();
+
+    Tracing::Reset();
+
+    Tracing::BeginRegion("Kept");
+    Tracing::EndRegion();
+
+    rdcstr json = Tracing::GetChromeTrace();
+
+    CHECK(!json.contains("Discarded"));
+    CHECK(json.contains("Kept"));
+  };
+
+  SECTION("Overwritten begins don't leave unmatched ends")
+  {
+    Tracing::BeginRegion("Overwritten");
+    for(uint32_t i = 0; i < Tracing::ThreadTrace::Capacity; i++)
+    {
+      Tracing::BeginRegion("Filler");
+      Tracing::EndRegion();
+    }
+    Tracing::EndRegion();
+
+    rdcstr json = Tracing::GetChromeTrace();
+
+    CHECK(!json.contains("Overwritten"));
+    CHECK(CountOccurrences(json, "\"ph\":\"B\"") == CountOccurrences(json, "\"ph\":\"E\""));
+  };
+
+  SECTION("Nothing is recorded while disabled")
+  {
+    Tracing::Enable(false);
+
+    Tracing::BeginRegion("Disabled");
+    Tracing::EndRegion();
+
+    Tracing::Enable(true);
+
+    CHECK(!Tracing::GetChromeTrace().contains("Disabled"));
+  };
+
+  Tracing::Reset();
+  Tracing::Enable(false);
+}
+
+TEST_CASE("Benchmark profile region tracing", "[.][tracing][benchmark]")
+{
+  const uint32_t numRegions = 1000000;
+
+  Tracing::Enable(false);
+
+  PerformanceTimer timer;
+  for(uint32_t i = 0; i < numRegions; i++)
+  {
+    RENDERDOC_PROFILEFUNCTION();
+  }
+  double disabledTime = timer.GetMilliseconds();
+
+  Tracing::Enable(true);
+  Tracing::Reset();
+
+  timer.Restart();
+  for(uint32_t i = 0; i < numRegions; i++)
+  {
+    RENDERDOC_PROFILEFUNCTION();
+  }
+  double enabledTime = timer.GetMilliseconds();
+
+  timer.Restart();
+  rdcstr json = Tracing::GetChromeTrace();
+  double writeTime = timer.GetMilliseconds();
+
+  Tracing::Reset();
+  Tracing::Enable(false);
+
+  RDCLOG("%u regions: %.2f ms disabled, %.2f ms traced. %.2f ms to generate %u bytes of JSON",
+         numRegions, disabledTime, enabledTime, writeTime, (uint32_t)json.size());
+}
+
+#endif    // ENABLED(ENABLE_UNIT_TESTS)
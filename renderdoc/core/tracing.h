@@ -0,0 +1,62 @@
+/******************************************************************************
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019-2024 Baldur Karlsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+
+#pragma once
+
+#include "api/replay/rdcstr.h"
+#include "os/os_specific.h"
+
+// A lightweight built-in tracer for profile regions (RENDERDOC_PROFILEREGION and
+// RENDERDOC_PROFILEFUNCTION). Each thread records begin/end events into its own fixed-size ring
+// buffer without taking any locks, and overwrites its oldest events once the buffer is full. The
+// recorded events can be written out as Chrome trace event JSON, which chrome://tracing and the
+// Perfetto UI can both load.
+namespace Tracing
+{
+// read on every region begin/end through IsActive()
+extern int32_t TracingActive;
+
+inline bool IsActive()
+{
+  return Atomic::Load32(&TracingActive) != 0;
+}
+
+void Enable(bool enable);
+
+// the name must stay valid for the lifetime of the process - e.g. a string literal or
+// __PRETTY_FUNCTION__. Only the pointer is recorded.
+void BeginRegion(const char *name);
+// the name is interned the first time it's seen, so it's best to use the overload above.
+void BeginRegion(const rdcstr &name);
+void EndRegion();
+
+// discard all events recorded so far
+void Reset();
+
+// returns all events recorded so far as Chrome trace event JSON. This should be called while no
+// other threads are recording, otherwise events being written concurrently may be lost.
+rdcstr GetChromeTrace();
+bool WriteChromeTrace(const rdcstr &filename);
+};
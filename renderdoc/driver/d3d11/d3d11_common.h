@@ -549,3 +549,7 @@ DECLARE_REFLECTION_STRUCT(D3D11_SUBRESOURCE_DATA);
 DECLARE_REFLECTION_STRUCT(D3D11_VIEWPORT);
 DECLARE_REFLECTION_STRUCT(D3D11_RECT);
 DECLARE_REFLECTION_STRUCT(D3D11_BOX);
+
+// structs serialised exactly as they're laid out in memory, so arrays of them can be bulk copied
+DECLARE_SERIALISE_POD(D3D11_VIEWPORT);
+DECLARE_SERIALISE_POD(D3D11_BOX);
@@ -172,7 +172,7 @@ private:
   bool m_NeedUpdateSubWorkaround;
 
   WriteSerialiser m_ScratchSerialiser;
-  std::set<rdcstr> m_StringDB;
+  StringDatabase m_StringDB;
 
   ResourceId m_CurContextId;
   D3DDescriptorStore *m_DescriptorStore;
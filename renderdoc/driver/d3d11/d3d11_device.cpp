@@ -1995,6 +1995,8 @@ void WrappedID3D11Device::StartFrameCapture(DeviceOwnedWindow devWnd)
 
   RDCLOG("Starting capture");
 
+  Threading::ResetLockProfile();
+
   m_CaptureTimer.Restart();
 
   m_State = CaptureState::ActiveCapturing;
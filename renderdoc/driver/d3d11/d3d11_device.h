@@ -565,7 +565,7 @@ private:
   bool m_D3DThreadSafe = false;
 
   WriteSerialiser m_ScratchSerialiser;
-  std::set<rdcstr> m_StringDB;
+  StringDatabase m_StringDB;
 
   ResourceId m_ResourceID;
   D3D11ResourceRecord *m_DeviceRecord;
@@ -191,7 +191,7 @@ class WrappedID3D12CommandQueue : public ID3D12CommandQueue,
   // D3D12 guarantees that queues are thread-safe
   Threading::CriticalSection m_Lock;
 
-  std::set<rdcstr> m_StringDB;
+  StringDatabase m_StringDB;
 
   WriteSerialiser &GetThreadSerialiser();
 
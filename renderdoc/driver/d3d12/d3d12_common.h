@@ -1089,6 +1089,10 @@ DECLARE_DESERIALISE_TYPE(D3D12_DXIL_SUBOBJECT_TO_EXPORTS_ASSOCIATION);
 DECLARE_DESERIALISE_TYPE(D3D12_HIT_GROUP_DESC);
 DECLARE_DESERIALISE_TYPE(D3D12_EXPORT_DESC);
 
+// structs serialised exactly as they're laid out in memory, so arrays of them can be bulk copied
+DECLARE_SERIALISE_POD(D3D12_VIEWPORT);
+DECLARE_SERIALISE_POD(D3D12_BOX);
+
 enum class D3D12Chunk : uint32_t
 {
   SetName = (uint32_t)SystemChunk::FirstDriverChunk,
@@ -2551,6 +2551,8 @@ void WrappedID3D12Device::StartFrameCapture(DeviceOwnedWindow devWnd)
 
   RDCLOG("Starting capture");
 
+  Threading::ResetLockProfile();
+
   if(m_Queue == NULL)
   {
     RDCLOG("Creating direct queue as none was found in the application");
@@ -764,7 +764,7 @@ private:
   D3D12ResourceRecord *m_FrameCaptureRecord;
   Chunk *m_HeaderChunk;
 
-  std::set<rdcstr> m_StringDB;
+  StringDatabase m_StringDB;
 
   ResourceId m_ResourceID;
   D3D12ResourceRecord *m_DeviceRecord;
@@ -3127,30 +3127,15 @@ void D3D12Replay::InitPostVSBuffers(uint32_t eventId)
 
       rdcarray<uint32_t> indices;
 
-      uint16_t *idx16 = (uint16_t *)&idxdata[0];
-      uint32_t *idx32 = (uint32_t *)&idxdata[0];
-
       // only read as many indices as were available in the buffer
       uint32_t numIndices =
           RDCMIN(uint32_t(idxdata.size() / RDCMAX(1, rs.ibuffer.bytewidth)), action->numIndices);
 
-      // grab all unique vertex indices referenced
-      for(uint32_t i = 0; i < numIndices; i++)
-      {
-        uint32_t i32 = rs.ibuffer.bytewidth == 2 ? uint32_t(idx16[i]) : idx32[i];
-
-        auto it = std::lower_bound(indices.begin(), indices.end(), i32);
-
-        if(it != indices.end() && *it == i32)
-          continue;
-
-        indices.insert(it - indices.begin(), i32);
-      }
-
-      // if we read out of bounds, we'll also have a 0 index being referenced
-      // (as 0 is read). Don't insert 0 if we already have 0 though
-      if(numIndices < action->numIndices && (indices.empty() || indices[0] != 0))
-        indices.insert(0, 0);
+      uint32_t stripCutValue = 0;
+      if(psoDesc.IBStripCutValue == D3D12_INDEX_BUFFER_STRIP_CUT_VALUE_0xFFFF)
+        stripCutValue = 0xffff;
+      else if(psoDesc.IBStripCutValue == D3D12_INDEX_BUFFER_STRIP_CUT_VALUE_0xFFFFFFFF)
+        stripCutValue = 0xffffffff;
 
       // An index buffer could be something like: 500, 501, 502, 501, 503, 502
       // in which case we can't use the existing index buffer without filling 499 slots of vertex
@@ -3162,15 +3147,13 @@ void D3D12Replay::InitPostVSBuffers(uint32_t eventId)
       // We just stream-out a tightly packed list of unique indices, and then remap the index buffer
       // so that what did point to 500 points to 0 (accounting for rebasing), and what did point
       // to 510 now points to 3 (accounting for the unique sort).
-
-      // we use a map here since the indices may be sparse. Especially considering if an index
-      // is 'invalid' like 0xcccccccc then we don't want an array of 3.4 billion entries.
-      std::map<uint32_t, size_t> indexRemap;
-      for(size_t i = 0; i < indices.size(); i++)
-      {
-        // by definition, this index will only appear once in indices[]
-        indexRemap[indices[i]] = i;
-      }
+      //
+      // The index buffer is rebased in place to point to the right elements in our stream-out'd
+      // vertex buffer, preserving primitive restart indices.
+      //
+      // if we read out of bounds, we'll also have a 0 index being referenced (as 0 is read).
+      DeduplicateIndices(idxdata.data(), rs.ibuffer.bytewidth == 2 ? 2 : 4, numIndices, 0, ~0U,
+                         stripCutValue, numIndices < action->numIndices, indices);
 
       outputSize = uint64_t(indices.size() * sizeof(uint32_t) * sizeof(Vec4f));
 
@@ -3229,28 +3212,6 @@ void D3D12Replay::InitPostVSBuffers(uint32_t eventId)
       list->DrawIndexedInstanced((UINT)indices.size(), action->numInstances, 0, action->baseVertex,
                                  action->instanceOffset);
 
-      uint32_t stripCutValue = 0;
-      if(psoDesc.IBStripCutValue == D3D12_INDEX_BUFFER_STRIP_CUT_VALUE_0xFFFF)
-        stripCutValue = 0xffff;
-      else if(psoDesc.IBStripCutValue == D3D12_INDEX_BUFFER_STRIP_CUT_VALUE_0xFFFFFFFF)
-        stripCutValue = 0xffffffff;
-
-      // rebase existing index buffer to point to the right elements in our stream-out'd
-      // vertex buffer
-      for(uint32_t i = 0; i < numIndices; i++)
-      {
-        uint32_t i32 = rs.ibuffer.bytewidth == 2 ? uint32_t(idx16[i]) : idx32[i];
-
-        // preserve primitive restart indices
-        if(stripCutValue && i32 == stripCutValue)
-          continue;
-
-        if(rs.ibuffer.bytewidth == 2)
-          idx16[i] = uint16_t(indexRemap[i32]);
-        else
-          idx32[i] = uint32_t(indexRemap[i32]);
-      }
-
       idxBuf = NULL;
 
       if(!idxdata.empty())
@@ -2230,6 +2230,8 @@ void WrappedOpenGL::StartFrameCapture(DeviceOwnedWindow devWnd)
 
   RDCLOG("Starting capture");
 
+  Threading::ResetLockProfile();
+
   m_CaptureTimer.Restart();
 
   SCOPED_LOCK(glLock);
@@ -3379,6 +3381,8 @@ void WrappedOpenGL::AddResourceInitChunk(GLResource res)
 
 RDResult WrappedOpenGL::ReadLogInitialisation(RDCFile *rdc, bool storeStructuredBuffers)
 {
+  RENDERDOC_PROFILEFUNCTION();
+
   int sectionIdx = rdc->SectionIndex(SectionType::FrameCapture);
 
   if(sectionIdx < 0)
@@ -5166,6 +5170,8 @@ bool WrappedOpenGL::ProcessChunk(ReadSerialiser &ser, GLChunk chunk)
 RDResult WrappedOpenGL::ContextReplayLog(CaptureState readType, uint32_t startEventID,
                                          uint32_t endEventID, bool partial)
 {
+  RENDERDOC_PROFILEFUNCTION();
+
   m_FrameReader->SetOffset(0);
 
   ReadSerialiser ser(m_FrameReader, Ownership::Nothing);
@@ -177,7 +177,7 @@ private:
   ReplayOptions m_ReplayOptions;
 
   WriteSerialiser m_ScratchSerialiser;
-  std::set<rdcstr> m_StringDB;
+  StringDatabase m_StringDB;
 
   StreamReader *m_FrameReader = NULL;
 
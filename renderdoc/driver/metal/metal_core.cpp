@@ -521,6 +521,8 @@ void WrappedMTLDevice::StartFrameCapture(DeviceOwnedWindow devWnd)
     return;
 
   RDCLOG("Starting capture");
+
+  Threading::ResetLockProfile();
   {
     SCOPED_LOCK(m_CaptureCommandBuffersLock);
     RDCASSERT(m_CaptureCommandBuffersSubmitted.empty());
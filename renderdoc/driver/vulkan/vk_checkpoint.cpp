@@ -0,0 +1,591 @@
+/******************************************************************************
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Baldur Karlsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include "core/settings.h"
+#include "vk_core.h"
+
+RDOC_CONFIG(uint32_t, Vulkan_ReplayCheckpointBudgetMB, 0,
+            "Memory in MB that can be used for replay checkpoints, which snapshot resource "
+            "contents after queue submits so that seeking to a later event doesn't re-execute all "
+            "prior GPU work. 0 disables checkpoints.");
+RDOC_CONFIG(uint32_t, Vulkan_ReplayCheckpointIntervalMS, 50,
+            "Minimum replay time in milliseconds between replay checkpoints.");
+
+// Checkpoints are only taken at queue submit boundaries, when all GPU work so far in the frame has
+// been submitted and no partial command buffer state is pending. Everything on the CPU side is
+// still replayed as normal - command buffers are still re-recorded, host writes to memory are
+// still applied, and image layouts are still tracked - only the GPU execution of submits up to the
+// checkpoint is skipped and replaced by copying back the snapshotted contents.
+//
+// A checkpoint contains every range of device memory and every image that is written during the
+// frame, so it is only valid as long as replaying produces the same results. Anything which changes
+// that (such as replacing a shader) must invalidate all checkpoints.
+
+static bool IsCheckpointImage(const ImageState &state)
+{
+  if(!state.isMemoryBound || state.wrappedHandle == VK_NULL_HANDLE)
+    return false;
+
+  for(auto it = state.subresourceStates.begin(); it != state.subresourceStates.end(); ++it)
+  {
+    if(IsDirtyFrameRef(it->state().refType))
+      return true;
+  }
+
+  return false;
+}
+
+// copies of every subresource between two images with identical properties
+static rdcarray<VkImageCopy> GetWholeImageCopies(const ImageInfo &imageInfo)
+{
+  rdcarray<VkImageCopy> regions;
+  for(uint32_t m = 0; m < imageInfo.levelCount; m++)
+  {
+    VkExtent3D extent = {
+        RDCMAX(1U, imageInfo.extent.width >> m),
+        RDCMAX(1U, imageInfo.extent.height >> m),
+        RDCMAX(1U, imageInfo.extent.depth >> m),
+    };
+
+    regions.push_back({
+        {imageInfo.aspects, m, 0, imageInfo.layerCount},
+        {0, 0, 0},
+        {imageInfo.aspects, m, 0, imageInfo.layerCount},
+        {0, 0, 0},
+        extent,
+    });
+  }
+  return regions;
+}
+
+bool WrappedVulkan::EvaluateReplayCheckpointSupport()
+{
+  if(!m_SparseBindResources.empty())
+  {
+    RDCLOG("Replay checkpoints disabled: capture uses sparse resources");
+    return false;
+  }
+
+  if(!m_CreationInfo.m_AccelerationStructure.empty())
+  {
+    RDCLOG("Replay checkpoints disabled: capture uses acceleration structures");
+    return false;
+  }
+
+  if(m_Checkpoints.copiesQueryResults)
+  {
+    RDCLOG("Replay checkpoints disabled: capture copies query results");
+    return false;
+  }
+
+  bool anyMemRefs = false;
+  for(auto it = m_CreationInfo.m_Memory.begin(); it != m_CreationInfo.m_Memory.end(); ++it)
+  {
+    MemRefs *memRefs =
+        GetResourceManager()->FindMemRefs(GetResourceManager()->GetOriginalID(it->first));
+    if(!memRefs)
+      continue;
+
+    anyMemRefs = true;
+
+    if(it->second.wholeMemBuf == VK_NULL_HANDLE)
+    {
+      for(auto ref = memRefs->rangeRefs.begin(); ref != memRefs->rangeRefs.end(); ++ref)
+      {
+        if(IsDirtyFrameRef(ref->value()))
+        {
+          RDCLOG("Replay checkpoints disabled: written memory %s can't be copied",
+                 ToStr(it->first).c_str());
+          return false;
+        }
+      }
+    }
+  }
+
+  if(!anyMemRefs && !m_CreationInfo.m_Memory.empty())
+  {
+    RDCLOG("Replay checkpoints disabled: capture has no memory reference information");
+    return false;
+  }
+
+  SCOPED_LOCK(m_ImageStatesLock);
+  for(auto it = m_ImageStates.begin(); it != m_ImageStates.end(); ++it)
+  {
+    LockedConstImageStateRef state = it->second.LockRead();
+    if(IsCheckpointImage(*state) && GetYUVPlaneCount(state->GetImageInfo().format) > 1)
+    {
+      RDCLOG("Replay checkpoints disabled: capture writes to multi-planar image %s",
+             ToStr(it->first).c_str());
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void WrappedVulkan::BeginReplayCheckpoints(bool partial)
+{
+  m_Checkpoints.restoreEventId = 0;
+  m_Checkpoints.recording = false;
+
+  // partial replays only replay within a command buffer, and replays with callbacks or extra
+  // submit information are modifying the replay so can't use or create checkpoints
+  if(partial || m_ActionCallback || m_SubmitChain || Vulkan_ReplayCheckpointBudgetMB() == 0)
+    return;
+
+  if(!m_Checkpoints.evaluated)
+  {
+    m_Checkpoints.evaluated = true;
+    m_Checkpoints.supported = EvaluateReplayCheckpointSupport();
+  }
+
+  if(!m_Checkpoints.supported)
+    return;
+
+  // restore from the latest checkpoint that is entirely covered by this replay
+  for(const ReplayCheckpoint &checkpoint : m_Checkpoints.checkpoints)
+  {
+    if(checkpoint.eventId <= m_LastEventID)
+      m_Checkpoints.restoreEventId = checkpoint.eventId;
+  }
+
+  m_Checkpoints.recording = true;
+  m_Checkpoints.timer.Restart();
+}
+
+void WrappedVulkan::RecordReplayCheckpoint(uint32_t eventId)
+{
+  if(!m_Checkpoints.recording)
+    return;
+
+  for(const ReplayCheckpoint &checkpoint : m_Checkpoints.checkpoints)
+  {
+    // we already have a checkpoint here, count the interval from it
+    if(checkpoint.eventId == eventId)
+    {
+      m_Checkpoints.timer.Restart();
+      return;
+    }
+  }
+
+  if(m_Checkpoints.timer.GetMilliseconds() < (double)Vulkan_ReplayCheckpointIntervalMS())
+    return;
+
+  RENDERDOC_PROFILEFUNCTION();
+
+  VkDevice dev = GetDev();
+  const VkDevDispatchTable *vt = ObjDisp(dev);
+
+  ReplayCheckpoint checkpoint;
+  checkpoint.eventId = eventId;
+
+  // gather the memory ranges written in the frame, packing them into one buffer
+  VkDeviceSize memorySize = 0;
+  for(auto it = m_CreationInfo.m_Memory.begin(); it != m_CreationInfo.m_Memory.end(); ++it)
+  {
+    MemRefs *memRefs =
+        GetResourceManager()->FindMemRefs(GetResourceManager()->GetOriginalID(it->first));
+    if(!memRefs || it->second.wholeMemBuf == VK_NULL_HANDLE)
+      continue;
+
+    ReplayCheckpoint::MemoryContents contents;
+    contents.memory = it->first;
+
+    for(auto ref = memRefs->rangeRefs.begin(); ref != memRefs->rangeRefs.end(); ++ref)
+    {
+      if(!IsDirtyFrameRef(ref->value()) || ref->start() >= it->second.wholeMemBufSize)
+        continue;
+
+      VkDeviceSize start = ref->start();
+      VkDeviceSize finish = RDCMIN(ref->finish(), it->second.wholeMemBufSize);
+
+      // merge with the previous range if it's adjacent
+      if(!contents.regions.empty() &&
+         contents.regions.back().dstOffset + contents.regions.back().size == start)
+      {
+        contents.regions.back().size += finish - start;
+      }
+      else
+      {
+        contents.regions.push_back({memorySize, start, finish - start});
+      }
+
+      memorySize += finish - start;
+    }
+
+    if(!contents.regions.empty())
+      checkpoint.memory.push_back(contents);
+  }
+
+  rdcarray<ResourceId> images;
+  VkDeviceSize imageSize = 0;
+  {
+    SCOPED_LOCK(m_ImageStatesLock);
+    for(auto it = m_ImageStates.begin(); it != m_ImageStates.end(); ++it)
+    {
+      if(!GetResourceManager()->HasCurrentResource(it->first))
+        continue;
+
+      LockedConstImageStateRef state = it->second.LockRead();
+      if(IsCheckpointImage(*state))
+      {
+        images.push_back(it->first);
+        imageSize += m_CreationInfo.m_Image[it->first].mrq.size;
+      }
+    }
+  }
+
+  const uint64_t budget = uint64_t(Vulkan_ReplayCheckpointBudgetMB()) * 1024 * 1024;
+  if(CurMemoryUsage(MemoryScope::ReplayCheckpoint) + memorySize + imageSize > budget)
+  {
+    RDCDEBUG("Replay checkpoint at %u would exceed budget", eventId);
+    m_Checkpoints.recording = false;
+    return;
+  }
+
+  VkResult vkr = VK_SUCCESS;
+
+  // the submit may have been on any queue, so wait for all work to finish before copying
+  vkr = vt->DeviceWaitIdle(Unwrap(dev));
+  CheckVkResult(vkr);
+
+  VkCommandBuffer cmd = GetNextCmd();
+
+  if(cmd == VK_NULL_HANDLE)
+    return;
+
+  VkCommandBufferBeginInfo beginInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO, NULL,
+                                        VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT};
+
+  vkr = vt->BeginCommandBuffer(Unwrap(cmd), &beginInfo);
+  CheckVkResult(vkr);
+
+  VkMarkerRegion::Begin(StringFormat::Fmt("Replay checkpoint at %u", eventId), cmd);
+
+  VkMemoryBarrier memBarrier = {
+      VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+      NULL,
+      VK_ACCESS_ALL_WRITE_BITS,
+      VK_ACCESS_TRANSFER_READ_BIT,
+  };
+
+  DoPipelineBarrier(cmd, 1, &memBarrier);
+
+  if(memorySize > 0)
+  {
+    VkBufferCreateInfo bufInfo = {
+        VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+        NULL,
+        0,
+        memorySize,
+        VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+    };
+
+    vkr = vt->CreateBuffer(Unwrap(dev), &bufInfo, NULL, &checkpoint.memorySnapshot);
+    CheckVkResult(vkr);
+
+    VkMemoryRequirements mrq = {};
+    vt->GetBufferMemoryRequirements(Unwrap(dev), checkpoint.memorySnapshot, &mrq);
+
+    MemoryAllocation alloc = AllocateMemoryForResource(true, mrq, MemoryScope::ReplayCheckpoint,
+                                                       MemoryType::GPULocal);
+
+    if(alloc.mem == VK_NULL_HANDLE)
+    {
+      RDCWARN("Couldn't allocate replay checkpoint memory");
+      vt->DestroyBuffer(Unwrap(dev), checkpoint.memorySnapshot, NULL);
+      vt->EndCommandBuffer(Unwrap(cmd));
+      m_Checkpoints.recording = false;
+      return;
+    }
+
+    vkr = vt->BindBufferMemory(Unwrap(dev), checkpoint.memorySnapshot, Unwrap(alloc.mem),
+                               alloc.offs);
+    CheckVkResult(vkr);
+
+    for(const ReplayCheckpoint::MemoryContents &contents : checkpoint.memory)
+    {
+      // copy from the memory into the snapshot, so swap the offsets around
+      rdcarray<VkBufferCopy> regions = contents.regions;
+      for(VkBufferCopy &region : regions)
+        std::swap(region.srcOffset, region.dstOffset);
+
+      vt->CmdCopyBuffer(Unwrap(cmd), Unwrap(m_CreationInfo.m_Memory[contents.memory].wholeMemBuf),
+                        checkpoint.memorySnapshot, (uint32_t)regions.size(), regions.data());
+    }
+  }
+
+  ImageBarrierSequence setupBarriers, cleanupBarriers;
+  rdcarray<VkImageMemoryBarrier> snapshotBarriers;
+
+  for(ResourceId id : images)
+  {
+    LockedConstImageStateRef state = FindConstImageState(id);
+    const ImageInfo &imageInfo = state->GetImageInfo();
+
+    VkImageCreateInfo imCreateInfo = {
+        VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+        NULL,
+        0,
+        imageInfo.imageType,
+        imageInfo.format,
+        imageInfo.extent,
+        imageInfo.levelCount,
+        imageInfo.layerCount,
+        (VkSampleCountFlagBits)imageInfo.sampleCount,
+        VK_IMAGE_TILING_OPTIMAL,
+        VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+        VK_SHARING_MODE_EXCLUSIVE,
+        0,
+        NULL,
+        VK_IMAGE_LAYOUT_UNDEFINED,
+    };
+
+    ReplayCheckpoint::ImageContents contents;
+    contents.image = id;
+
+    vkr = vt->CreateImage(Unwrap(dev), &imCreateInfo, NULL, &contents.snapshot);
+    CheckVkResult(vkr);
+
+    if(vkr != VK_SUCCESS)
+      continue;
+
+    VkMemoryRequirements mrq = {};
+    vt->GetImageMemoryRequirements(Unwrap(dev), contents.snapshot, &mrq);
+
+    MemoryAllocation alloc = AllocateMemoryForResource(false, mrq, MemoryScope::ReplayCheckpoint,
+                                                       MemoryType::GPULocal);
+
+    if(alloc.mem == VK_NULL_HANDLE)
+    {
+      vt->DestroyImage(Unwrap(dev), contents.snapshot, NULL);
+      continue;
+    }
+
+    vkr = vt->BindImageMemory(Unwrap(dev), contents.snapshot, Unwrap(alloc.mem), alloc.offs);
+    CheckVkResult(vkr);
+
+    checkpoint.images.push_back(contents);
+
+    state->TempTransition(m_QueueFamilyIdx, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                          VK_ACCESS_TRANSFER_READ_BIT, setupBarriers, cleanupBarriers,
+                          GetImageTransitionInfo());
+
+    VkImageMemoryBarrier barrier = {
+        VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+        NULL,
+        0,
+        VK_ACCESS_TRANSFER_WRITE_BIT,
+        VK_IMAGE_LAYOUT_UNDEFINED,
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        VK_QUEUE_FAMILY_IGNORED,
+        VK_QUEUE_FAMILY_IGNORED,
+        contents.snapshot,
+        {imageInfo.aspects, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS},
+    };
+    snapshotBarriers.push_back(barrier);
+  }
+
+  InlineSetupImageBarriers(cmd, setupBarriers);
+  SubmitAndFlushImageStateBarriers(setupBarriers);
+
+  if(!snapshotBarriers.empty())
+    DoPipelineBarrier(cmd, snapshotBarriers.size(), snapshotBarriers.data());
+
+  for(const ReplayCheckpoint::ImageContents &contents : checkpoint.images)
+  {
+    LockedConstImageStateRef state = FindConstImageState(contents.image);
+    rdcarray<VkImageCopy> regions = GetWholeImageCopies(state->GetImageInfo());
+
+    VkImage live =
+        ToUnwrappedHandle<VkImage>(GetResourceManager()->GetCurrentResource(contents.image));
+
+    vt->CmdCopyImage(Unwrap(cmd), live, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, contents.snapshot,
+                     VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, (uint32_t)regions.size(), regions.data());
+  }
+
+  // leave the snapshots ready to be copied from when restoring
+  for(VkImageMemoryBarrier &barrier : snapshotBarriers)
+  {
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+  }
+
+  if(!snapshotBarriers.empty())
+    DoPipelineBarrier(cmd, snapshotBarriers.size(), snapshotBarriers.data());
+
+  InlineCleanupImageBarriers(cmd, cleanupBarriers);
+
+  VkMarkerRegion::End(cmd);
+
+  vkr = vt->EndCommandBuffer(Unwrap(cmd));
+  CheckVkResult(vkr);
+
+  SubmitCmds();
+  FlushQ();
+
+  SubmitAndFlushImageStateBarriers(cleanupBarriers);
+
+  RDCDEBUG("Took replay checkpoint at %u: %zu memory ranges and %zu images", eventId,
+           checkpoint.memory.size(), checkpoint.images.size());
+
+  size_t idx = 0;
+  while(idx < m_Checkpoints.checkpoints.size() && m_Checkpoints.checkpoints[idx].eventId < eventId)
+    idx++;
+  m_Checkpoints.checkpoints.insert(idx, checkpoint);
+
+  m_Checkpoints.timer.Restart();
+}
+
+void WrappedVulkan::RestoreReplayCheckpoint()
+{
+  const ReplayCheckpoint *checkpoint = NULL;
+  for(const ReplayCheckpoint &c : m_Checkpoints.checkpoints)
+    if(c.eventId == m_Checkpoints.restoreEventId)
+      checkpoint = &c;
+
+  m_Checkpoints.restoreEventId = 0;
+
+  if(!checkpoint)
+  {
+    RDCERR("Replay checkpoint to restore is missing");
+    return;
+  }
+
+  RENDERDOC_PROFILEFUNCTION();
+
+  VkDevice dev = GetDev();
+  const VkDevDispatchTable *vt = ObjDisp(dev);
+
+  VkCommandBuffer cmd = GetNextCmd();
+
+  if(cmd == VK_NULL_HANDLE)
+    return;
+
+  VkResult vkr = VK_SUCCESS;
+
+  VkCommandBufferBeginInfo beginInfo = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO, NULL,
+                                        VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT};
+
+  vkr = vt->BeginCommandBuffer(Unwrap(cmd), &beginInfo);
+  CheckVkResult(vkr);
+
+  VkMarkerRegion::Begin(StringFormat::Fmt("Restore replay checkpoint at %u", checkpoint->eventId),
+                        cmd);
+
+  VkMemoryBarrier memBarrier = {
+      VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+      NULL,
+      VK_ACCESS_ALL_WRITE_BITS,
+      VK_ACCESS_TRANSFER_WRITE_BIT,
+  };
+
+  DoPipelineBarrier(cmd, 1, &memBarrier);
+
+  for(const ReplayCheckpoint::MemoryContents &contents : checkpoint->memory)
+  {
+    vt->CmdCopyBuffer(Unwrap(cmd), checkpoint->memorySnapshot,
+                      Unwrap(m_CreationInfo.m_Memory[contents.memory].wholeMemBuf),
+                      (uint32_t)contents.regions.size(), contents.regions.data());
+  }
+
+  // images are copied after memory, so any image contents in written memory ranges are correct
+  memBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+  DoPipelineBarrier(cmd, 1, &memBarrier);
+
+  ImageBarrierSequence setupBarriers, cleanupBarriers;
+
+  for(const ReplayCheckpoint::ImageContents &contents : checkpoint->images)
+  {
+    LockedConstImageStateRef state = FindConstImageState(contents.image);
+
+    state->TempTransition(m_QueueFamilyIdx, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                          VK_ACCESS_TRANSFER_WRITE_BIT, setupBarriers, cleanupBarriers,
+                          GetImageTransitionInfo());
+  }
+
+  InlineSetupImageBarriers(cmd, setupBarriers);
+  SubmitAndFlushImageStateBarriers(setupBarriers);
+
+  for(const ReplayCheckpoint::ImageContents &contents : checkpoint->images)
+  {
+    LockedConstImageStateRef state = FindConstImageState(contents.image);
+    rdcarray<VkImageCopy> regions = GetWholeImageCopies(state->GetImageInfo());
+
+    VkImage live =
+        ToUnwrappedHandle<VkImage>(GetResourceManager()->GetCurrentResource(contents.image));
+
+    vt->CmdCopyImage(Unwrap(cmd), contents.snapshot, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, live,
+                     VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, (uint32_t)regions.size(), regions.data());
+  }
+
+  InlineCleanupImageBarriers(cmd, cleanupBarriers);
+
+  memBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+  memBarrier.dstAccessMask = VK_ACCESS_ALL_READ_BITS | VK_ACCESS_ALL_WRITE_BITS;
+  DoPipelineBarrier(cmd, 1, &memBarrier);
+
+  VkMarkerRegion::End(cmd);
+
+  vkr = vt->EndCommandBuffer(Unwrap(cmd));
+  CheckVkResult(vkr);
+
+  // subsequent submits may be on other queues, so the restore must be complete before continuing
+  SubmitCmds();
+  FlushQ();
+
+  SubmitAndFlushImageStateBarriers(cleanupBarriers);
+
+  m_Checkpoints.timer.Restart();
+}
+
+void WrappedVulkan::FreeReplayCheckpoints()
+{
+  VkDevice dev = GetDev();
+
+  for(ReplayCheckpoint &checkpoint : m_Checkpoints.checkpoints)
+  {
+    if(checkpoint.memorySnapshot != VK_NULL_HANDLE)
+      ObjDisp(dev)->DestroyBuffer(Unwrap(dev), checkpoint.memorySnapshot, NULL);
+
+    for(ReplayCheckpoint::ImageContents &contents : checkpoint.images)
+      ObjDisp(dev)->DestroyImage(Unwrap(dev), contents.snapshot, NULL);
+  }
+
+  m_Checkpoints.checkpoints.clear();
+
+  FreeAllMemory(MemoryScope::ReplayCheckpoint);
+}
+
+void WrappedVulkan::InvalidateReplayCheckpoints()
+{
+  if(m_Checkpoints.checkpoints.empty())
+    return;
+
+  FlushQ();
+
+  FreeReplayCheckpoints();
+}
@@ -452,6 +452,7 @@ enum class MemoryScope : uint8_t
   // allocated the same way
   ImmutableReplayDebug = InitialContents,
   IndirectReadback,
+  ReplayCheckpoint,
   Count,
 };
 
@@ -2178,6 +2179,16 @@ DECLARE_DESERIALISE_TYPE(VkExternalFormatANDROID);
 DECLARE_DESERIALISE_TYPE(VkAndroidHardwareBufferFormatProperties2ANDROID);
 #endif
 
+// structs serialised exactly as they're laid out in memory, so arrays of them can be bulk copied
+DECLARE_SERIALISE_POD(VkOffset2D);
+DECLARE_SERIALISE_POD(VkOffset3D);
+DECLARE_SERIALISE_POD(VkExtent2D);
+DECLARE_SERIALISE_POD(VkExtent3D);
+DECLARE_SERIALISE_POD(VkRect2D);
+DECLARE_SERIALISE_POD(VkViewport);
+DECLARE_SERIALISE_POD(VkClearRect);
+DECLARE_SERIALISE_POD(VkBufferCopy);
+
 // we add these fake enums so we have a type for type-dispatch in the serialiser. Due to C ABI rules
 // the vulkan API doesn't define native 64-bit enums itself
 //
@@ -46,6 +46,10 @@ RDOC_DEBUG_CONFIG(bool, Vulkan_Debug_SingleSubmitFlushing, false,
 RDOC_DEBUG_CONFIG(bool, Vulkan_Experimental_EnableRTSupport, false,
                   "Enable experimental Vulkan RT support");
 
+RDOC_DEBUG_CONFIG(bool, Vulkan_Debug_ReplayAllCommandChunks, false,
+                  "Deserialise every recorded command on replay, even those in command buffers "
+                  "that aren't being re-recorded.");
+
 uint64_t VkInitParams::GetSerialiseSize()
 {
   // misc bytes and fixed integer members
@@ -2197,6 +2201,8 @@ void WrappedVulkan::StartFrameCapture(DeviceOwnedWindow devWnd)
 
   RDCLOG("Starting capture");
 
+  Threading::ResetLockProfile();
+
   if(m_Queue == VK_NULL_HANDLE && m_QueueFamilyIdx != ~0U)
   {
     RDCLOG("Creating desired queue as none was obtained by the application");
@@ -2966,6 +2972,8 @@ void WrappedVulkan::AddResourceCurChunk(ResourceId id)
 
 RDResult WrappedVulkan::ReadLogInitialisation(RDCFile *rdc, bool storeStructuredBuffers)
 {
+  RENDERDOC_PROFILEFUNCTION();
+
   int sectionIdx = rdc->SectionIndex(SectionType::FrameCapture);
 
   GetResourceManager()->SetState(m_State);
@@ -3200,9 +3208,84 @@ RDResult WrappedVulkan::ReadLogInitialisation(RDCFile *rdc, bool storeStructured
   return ResultCode::Succeeded;
 }
 
+// commands which on active replay only execute into a re-recorded command buffer, without
+// updating any tracked state otherwise. When their command buffer isn't being re-recorded the
+// whole chunk can be skipped without changing the replay.
+static bool IsSkippableCmdChunk(VulkanChunk chunk)
+{
+  switch(chunk)
+  {
+    case VulkanChunk::vkCmdDraw:
+    case VulkanChunk::vkCmdDrawIndexed:
+    case VulkanChunk::vkCmdDrawMeshTasksEXT:
+    case VulkanChunk::vkCmdDispatch:
+    case VulkanChunk::vkCmdDispatchBase:
+    case VulkanChunk::vkCmdDispatchIndirect:
+    case VulkanChunk::vkCmdTraceRaysKHR:
+    case VulkanChunk::vkCmdTraceRaysIndirectKHR:
+    case VulkanChunk::vkCmdCopyBuffer:
+    case VulkanChunk::vkCmdCopyImage:
+    case VulkanChunk::vkCmdCopyBufferToImage:
+    case VulkanChunk::vkCmdCopyImageToBuffer:
+    case VulkanChunk::vkCmdBlitImage:
+    case VulkanChunk::vkCmdResolveImage:
+    case VulkanChunk::vkCmdClearColorImage:
+    case VulkanChunk::vkCmdClearDepthStencilImage:
+    case VulkanChunk::vkCmdClearAttachments:
+    case VulkanChunk::vkCmdFillBuffer:
+    case VulkanChunk::vkCmdUpdateBuffer:
+    case VulkanChunk::vkCmdPushConstants:
+    case VulkanChunk::vkCmdBindPipeline:
+    case VulkanChunk::vkCmdBindDescriptorSets:
+    case VulkanChunk::vkCmdBindVertexBuffers:
+    case VulkanChunk::vkCmdBindVertexBuffers2:
+    case VulkanChunk::vkCmdBindIndexBuffer:
+    case VulkanChunk::vkCmdSetViewport:
+    case VulkanChunk::vkCmdSetScissor:
+    case VulkanChunk::vkCmdSetLineWidth:
+    case VulkanChunk::vkCmdSetDepthBias:
+    case VulkanChunk::vkCmdSetBlendConstants:
+    case VulkanChunk::vkCmdSetDepthBounds:
+    case VulkanChunk::vkCmdSetStencilCompareMask:
+    case VulkanChunk::vkCmdSetStencilWriteMask:
+    case VulkanChunk::vkCmdSetStencilReference:
+    case VulkanChunk::vkCmdSetCullMode:
+    case VulkanChunk::vkCmdSetFrontFace:
+    case VulkanChunk::vkCmdSetPrimitiveTopology:
+    case VulkanChunk::vkCmdSetDepthTestEnable:
+    case VulkanChunk::vkCmdSetDepthWriteEnable:
+    case VulkanChunk::vkCmdSetDepthCompareOp:
+    case VulkanChunk::vkCmdDebugMarkerBeginEXT:
+    case VulkanChunk::vkCmdDebugMarkerEndEXT:
+    case VulkanChunk::vkCmdDebugMarkerInsertEXT:
+    case VulkanChunk::vkCmdBeginDebugUtilsLabelEXT:
+    case VulkanChunk::vkCmdEndDebugUtilsLabelEXT:
+    case VulkanChunk::vkCmdInsertDebugUtilsLabelEXT: return true;
+    default: break;
+  }
+
+  return false;
+}
+
+ResourceId WrappedVulkan::GetSkippableCmd(uint64_t fileOffset)
+{
+  if(Vulkan_Debug_ReplayAllCommandChunks())
+    return ResourceId();
+
+  SkippableCmd search(fileOffset, ResourceId());
+  auto it = std::lower_bound(m_SkippableCmds.begin(), m_SkippableCmds.end(), search);
+
+  if(it != m_SkippableCmds.end() && it->fileOffset == fileOffset)
+    return it->cmdId;
+
+  return ResourceId();
+}
+
 RDResult WrappedVulkan::ContextReplayLog(CaptureState readType, uint32_t startEventID,
                                          uint32_t endEventID, bool partial)
 {
+  RENDERDOC_PROFILEFUNCTION();
+
   m_FrameReader->SetOffset(0);
 
   ReadSerialiser ser(m_FrameReader, Ownership::Nothing);
@@ -3223,6 +3306,9 @@ RDResult WrappedVulkan::ContextReplayLog(CaptureState readType, uint32_t startEv
     m_StructuredFile = &ser.GetStructuredFile();
   }
 
+  if(IsLoading(m_State))
+    m_SkippableCmds.clear();
+
   SystemChunk header = ser.ReadChunk<SystemChunk>();
   RDCASSERTEQUAL(header, SystemChunk::CaptureBegin);
 
@@ -3286,6 +3372,8 @@ RDResult WrappedVulkan::ContextReplayLog(CaptureState readType, uint32_t startEv
     // that we ended up selecting (the one that was closest)
     if(startEventID == endEventID && m_RootEventID != m_FirstEventID)
       m_FirstEventID = m_LastEventID = m_RootEventID;
+
+    BeginReplayCheckpoints(partial);
   }
   else
   {
@@ -3320,7 +3408,27 @@ RDResult WrappedVulkan::ContextReplayLog(CaptureState readType, uint32_t startEv
 
     m_LastCmdBufferID = ResourceId();
 
-    bool success = ContextProcessChunk(ser, chunktype);
+    bool success = true;
+
+    ResourceId skipCmd;
+    if(IsActiveReplaying(m_State))
+      skipCmd = GetSkippableCmd(m_CurChunkOffset);
+
+    if(skipCmd != ResourceId() && !InRerecordRange(skipCmd))
+    {
+      // the command would be decoded only to be discarded, so don't decode it at all. We still
+      // need to know which command buffer it's in for the event bookkeeping below
+      m_LastCmdBufferID = skipCmd;
+      ser.SkipCurrentChunk();
+    }
+    else
+    {
+      success = ContextProcessChunk(ser, chunktype);
+
+      if(IsLoading(m_State) && success && m_LastCmdBufferID != ResourceId() &&
+         IsSkippableCmdChunk(chunktype))
+        m_SkippableCmds.push_back(SkippableCmd(m_CurChunkOffset, m_LastCmdBufferID));
+    }
 
     ser.EndChunk();
 
@@ -363,7 +363,7 @@ private:
 
   StreamReader *m_FrameReader = NULL;
 
-  std::set<rdcstr> m_StringDB;
+  StringDatabase m_StringDB;
 
   Threading::CriticalSection m_CapDescriptorsLock;
   std::set<rdcpair<ResourceId, VkResourceRecord *>> m_CapDescriptors;
@@ -777,6 +777,21 @@ private:
   };
   rdcarray<ActionUse> m_ActionUses;
 
+  // this is a sorted list of uint64_t file offset -> original command buffer ID for recorded
+  // commands that do nothing on replay unless their command buffer is being re-recorded. It's built
+  // while loading so that active replays can skip deserialising those chunks entirely when the
+  // command buffer is outside the range being replayed.
+  struct SkippableCmd
+  {
+    SkippableCmd(uint64_t offs, ResourceId cmd) : fileOffset(offs), cmdId(cmd) {}
+    uint64_t fileOffset;
+    ResourceId cmdId;
+    bool operator<(const SkippableCmd &o) const { return fileOffset < o.fileOffset; }
+  };
+  rdcarray<SkippableCmd> m_SkippableCmds;
+
+  ResourceId GetSkippableCmd(uint64_t fileOffset);
+
   // during active replay, command buffers may be partially-submitted if the selected event occurs
   // within the range of the command buffer. If secondary command buffers are used and the selected
   // event occurs within the range of a secondary, both the secondary and the command buffer that
@@ -1074,6 +1089,63 @@ private:
 
   std::set<ResourceId> m_SparseBindResources;
 
+  // snapshots of GPU-written resource contents taken after queue submits during a full replay.
+  // Later full replays up to an event past a checkpoint restore it and skip executing the submits
+  // before it, so seeking around a long frame doesn't re-run all prior GPU work. See
+  // vk_checkpoint.cpp
+  struct ReplayCheckpoint
+  {
+    struct MemoryContents
+    {
+      ResourceId memory;
+      // srcOffset is in the checkpoint buffer, dstOffset is in the memory
+      rdcarray<VkBufferCopy> regions;
+    };
+
+    struct ImageContents
+    {
+      ResourceId image;
+      // unwrapped, in TRANSFER_SRC_OPTIMAL layout
+      VkImage snapshot;
+    };
+
+    // the last event of the submit this checkpoint was taken after
+    uint32_t eventId = 0;
+
+    // unwrapped buffer holding all memory contents
+    VkBuffer memorySnapshot = VK_NULL_HANDLE;
+    rdcarray<MemoryContents> memory;
+    rdcarray<ImageContents> images;
+  };
+
+  struct ReplayCheckpointData
+  {
+    // sorted by eventId
+    rdcarray<ReplayCheckpoint> checkpoints;
+
+    // whether the capture is suitable for checkpoints at all, determined on first use
+    bool evaluated = false;
+    bool supported = false;
+
+    // set while loading if query results are copied, since query pool contents aren't snapshotted
+    bool copiesQueryResults = false;
+
+    // the checkpoint being restored in the current replay, or 0. Submits up to and including this
+    // event are not executed
+    uint32_t restoreEventId = 0;
+    // whether new checkpoints can be taken in the current replay
+    bool recording = false;
+
+    // time since the last checkpoint or the start of the replay
+    PerformanceTimer timer;
+  } m_Checkpoints;
+
+  void BeginReplayCheckpoints(bool partial);
+  bool EvaluateReplayCheckpointSupport();
+  void RecordReplayCheckpoint(uint32_t eventId);
+  void RestoreReplayCheckpoint();
+  void FreeReplayCheckpoints();
+
   RDResult m_FailedReplayResult = ResultCode::APIReplayFailed;
 
   VulkanActionTreeNode m_ParentAction;
@@ -1398,6 +1470,9 @@ public:
   bool EraseImageState(ResourceId id);
   void UpdateImageStates(const rdcflatmap<ResourceId, ImageState> &dstStates);
 
+  // must be called whenever replay results may change, e.g. when resources are replaced
+  void InvalidateReplayCheckpoints();
+
   inline ImageTransitionInfo GetImageTransitionInfo() const
   {
     return ImageTransitionInfo(m_State, m_QueueFamilyIdx, SeparateDepthStencil());
@@ -4511,9 +4511,6 @@ void VulkanReplay::FetchVSOut(uint32_t eventId, VulkanRenderState &state)
     const bool restart = state.primRestartEnable != VK_FALSE;
     bytebuf idxdata;
     rdcarray<uint32_t> indices;
-    uint8_t *idx8 = NULL;
-    uint16_t *idx16 = NULL;
-    uint32_t *idx32 = NULL;
 
     // fetch ibuffer
     if(state.ibuffer.buf != ResourceId())
@@ -4558,66 +4555,9 @@ void VulkanReplay::FetchVSOut(uint32_t eventId, VulkanRenderState &state)
 
     // do ibuffer rebasing/remapping
 
-    if(idxsize == 4)
-      idx32 = (uint32_t *)&idxdata[0];
-    else if(idxsize == 1)
-      idx8 = (uint8_t *)&idxdata[0];
-    else
-      idx16 = (uint16_t *)&idxdata[0];
-
     // only read as many indices as were available in the buffer
     uint32_t numIndices = RDCMIN(uint32_t(idxdata.size() / idxsize), action->numIndices);
 
-    uint32_t idxclamp = 0;
-    if(action->baseVertex < 0)
-      idxclamp = uint32_t(-action->baseVertex);
-
-    // grab all unique vertex indices referenced
-    for(uint32_t i = 0; i < numIndices; i++)
-    {
-      uint32_t i32 = 0;
-      if(idx32)
-        i32 = idx32[i];
-      else if(idx16)
-        i32 = uint32_t(idx16[i]);
-      else if(idx8)
-        i32 = uint32_t(idx8[i]);
-
-      // apply baseVertex but clamp to 0 (don't allow index to become negative)
-      if(i32 < idxclamp)
-        i32 = 0;
-      else if(action->baseVertex < 0)
-        i32 -= idxclamp;
-      else if(action->baseVertex > 0)
-        i32 += action->baseVertex;
-
-      // we clamp to maxIdx here, to avoid any invalid indices like 0xffffffff
-      // from filtering through. Worst case we index to the end of the vertex
-      // buffers which is generally much more reasonable
-      i32 = RDCMIN(maxIdx, i32);
-
-      // ignore primitive restart indices
-      if(restart && i32 == (0xffffffff >> ((4 - idxsize) * 8)))
-        continue;
-
-      auto it = std::lower_bound(indices.begin(), indices.end(), i32);
-
-      if(it != indices.end() && *it == i32)
-        continue;
-
-      indices.insert(it - indices.begin(), i32);
-    }
-
-    // if we read out of bounds, we'll also have a 0 index being referenced
-    // (as 0 is read). Don't insert 0 if we already have 0 though
-    if(numIndices < action->numIndices && (indices.empty() || indices[0] != 0))
-      indices.insert(0, 0);
-
-    maxIndex = indices.back();
-
-    // set numVerts
-    numVerts = (uint32_t)indices.size();
-
     // An index buffer could be something like: 500, 501, 502, 501, 503, 502
     // in which case we can't use the existing index buffer without filling 499 slots of vertex
     // data with padding. Instead we rebase the indices based on the smallest vertex so it becomes
@@ -4628,15 +4568,19 @@ void VulkanReplay::FetchVSOut(uint32_t eventId, VulkanRenderState &state)
     // We just stream-out a tightly packed list of unique indices, and then remap the index buffer
     // so that what did point to 500 points to 0 (accounting for rebasing), and what did point
     // to 510 now points to 3 (accounting for the unique sort).
+    //
+    // baseVertex is applied here, and indices are clamped to maxIdx to avoid any invalid indices
+    // like 0xffffffff from filtering through. Worst case we index to the end of the vertex
+    // buffers which is generally much more reasonable.
+    //
+    // if we read out of bounds, we'll also have a 0 index being referenced (as 0 is read).
+    DeduplicateIndices(idxdata.data(), idxsize, numIndices, action->baseVertex, maxIdx,
+                       restart ? ~0U : 0, numIndices < action->numIndices, indices);
 
-    // we use a map here since the indices may be sparse. Especially considering if an index
-    // is 'invalid' like 0xcccccccc then we don't want an array of 3.4 billion entries.
-    std::map<uint32_t, size_t> indexRemap;
-    for(size_t i = 0; i < indices.size(); i++)
-    {
-      // by definition, this index will only appear once in indices[]
-      indexRemap[indices[i]] = i;
-    }
+    maxIndex = indices.back();
+
+    // set numVerts
+    numVerts = (uint32_t)indices.size();
 
     // create buffer with unique 0-based indices
     VkBufferCreateInfo bufInfo = {
@@ -4710,38 +4654,6 @@ void VulkanReplay::FetchVSOut(uint32_t eventId, VulkanRenderState &state)
 
     m_pDriver->vkUnmapMemory(m_Device, uniqIdxBufMem);
 
-    // rebase existing index buffer to point to the right elements in our stream-out'd
-    // vertex buffer
-    for(uint32_t i = 0; i < numIndices; i++)
-    {
-      uint32_t i32 = 0;
-      if(idx32)
-        i32 = idx32[i];
-      else if(idx16)
-        i32 = uint32_t(idx16[i]);
-      else if(idx8)
-        i32 = uint32_t(idx8[i]);
-
-      // preserve primitive restart indices
-      if(restart && i32 == (0xffffffff >> ((4 - idxsize) * 8)))
-        continue;
-
-      // apply baseVertex but clamp to 0 (don't allow index to become negative)
-      if(i32 < idxclamp)
-        i32 = 0;
-      else if(action->baseVertex < 0)
-        i32 -= idxclamp;
-      else if(action->baseVertex > 0)
-        i32 += action->baseVertex;
-
-      if(idx32)
-        idx32[i] = uint32_t(indexRemap[i32]);
-      else if(idx16)
-        idx16[i] = uint16_t(indexRemap[i32]);
-      else if(idx8)
-        idx8[i] = uint8_t(indexRemap[i32]);
-    }
-
     bufInfo.size = RDCMAX((VkDeviceSize)64, (VkDeviceSize)idxdata.size());
     bufInfo.usage = VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
 
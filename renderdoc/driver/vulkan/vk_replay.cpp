@@ -4924,6 +4924,7 @@ void VulkanReplay::ReplaceResource(ResourceId from, ResourceId to)
 
   ClearPostVSCache();
   ClearFeedbackCache();
+  m_pDriver->InvalidateReplayCheckpoints();
 }
 
 void VulkanReplay::RemoveReplacement(ResourceId id)
@@ -4936,6 +4937,7 @@ void VulkanReplay::RemoveReplacement(ResourceId id)
 
     ClearPostVSCache();
     ClearFeedbackCache();
+    m_pDriver->InvalidateReplayCheckpoints();
   }
 }
 
@@ -4498,6 +4498,11 @@ bool WrappedVulkan::Serialise_vkCmdCopyQueryPoolResults(
       else
         commandBuffer = VK_NULL_HANDLE;
     }
+    else
+    {
+      // query pool contents aren't snapshotted, so replay checkpoints can't skip the queries
+      m_Checkpoints.copiesQueryResults = true;
+    }
 
     if(commandBuffer != VK_NULL_HANDLE)
     {
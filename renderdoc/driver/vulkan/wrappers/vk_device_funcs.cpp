@@ -1004,6 +1004,8 @@ void WrappedVulkan::Shutdown()
     }
   }
 
+  FreeReplayCheckpoints();
+
   FreeAllMemory(MemoryScope::InitialContents);
 
   if(m_MemoryFreeThread)
@@ -433,6 +433,25 @@ void WrappedVulkan::ReplayQueueSubmit(VkQueue queue, VkSubmitInfo2 submitInfo, r
       RDCDEBUG("Queue Submit no replay %u == %u", m_LastEventID, startEID);
 #endif
     }
+    else if(m_RootEventID <= m_Checkpoints.restoreEventId)
+    {
+#if ENABLED(VERBOSE_PARTIAL_REPLAY)
+      RDCDEBUG("Queue Submit skipped before checkpoint %u", m_Checkpoints.restoreEventId);
+#endif
+
+      // the results of this submit are in the checkpoint, but we still need to track the image
+      // layouts it would have transitioned to
+      for(uint32_t c = 0; c < submitInfo.commandBufferInfoCount; c++)
+      {
+        ResourceId cmdId = GetResourceManager()->GetOriginalID(
+            GetResID(submitInfo.pCommandBufferInfos[c].commandBuffer));
+
+        UpdateImageStates(m_BakedCmdBufferInfo[cmdId].imageStates);
+      }
+
+      if(m_RootEventID == m_Checkpoints.restoreEventId)
+        RestoreReplayCheckpoint();
+    }
     else
     {
 #if ENABLED(VERBOSE_PARTIAL_REPLAY)
@@ -503,6 +522,10 @@ void WrappedVulkan::ReplayQueueSubmit(VkQueue queue, VkSubmitInfo2 submitInfo, r
 
         DoSubmit(queue, submitInfo);
       }
+
+      // if the whole submit was replayed, this is a candidate point for a checkpoint
+      if(m_RootEventID <= m_LastEventID)
+        RecordReplayCheckpoint(m_RootEventID);
     }
   }
 
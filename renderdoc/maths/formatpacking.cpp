@@ -30,6 +30,14 @@
 #include "common/common.h"
 #include "os/os_specific.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#include <xmmintrin.h>
+#define FORMAT_PACKING_SSE2 OPTION_ON
+#else
+#define FORMAT_PACKING_SSE2 OPTION_OFF
+#endif
+
 //	for(int i=0; i < 256; i++)
 //	{
 //		uint8_t comp = i&0xff;
@@ -876,12 +884,565 @@ void DecodePixelData(const ResourceFormat &fmt, const byte *data, PixelValue &ou
   }
 }
 
+// The row conversion functions below produce bit-identical results to the per-pixel functions
+// above, but they select a conversion once per row and use SIMD kernels for the most common
+// formats. Any pixels not handled by a kernel (whether because of the format, or the tail of a row)
+// go through the per-pixel path.
+enum class RowFormat
+{
+  Generic,
+  RGBA8UNorm,
+  RGBA8SRGB,
+  RGBA16Float,
+  R10G10B10A2UNorm,
+  R11G11B10,
+  R9G9B9E5,
+  // 32-bit float components at any stride, as found in interleaved vertex data
+  Float32,
+};
+
+static RowFormat GetRowFormat(const ResourceFormat &fmt, uint32_t stride)
+{
+  if(fmt.type == ResourceFormatType::Regular && fmt.compType == CompType::Float &&
+     fmt.compByteWidth == 4 && fmt.compCount >= 1 && fmt.compCount <= 4 && !fmt.BGRAOrder())
+    return RowFormat::Float32;
+
+  if(stride != fmt.ElementSize())
+    return RowFormat::Generic;
+
+  if(fmt.type == ResourceFormatType::Regular && fmt.compCount == 4)
+  {
+    if(fmt.compByteWidth == 1 && fmt.compType == CompType::UNorm)
+      return RowFormat::RGBA8UNorm;
+    if(fmt.compByteWidth == 1 && fmt.compType == CompType::UNormSRGB)
+      return RowFormat::RGBA8SRGB;
+    if(fmt.compByteWidth == 2 && fmt.compType == CompType::Float && !fmt.BGRAOrder())
+      return RowFormat::RGBA16Float;
+  }
+  else if(fmt.type == ResourceFormatType::R10G10B10A2 && fmt.compType == CompType::UNorm)
+  {
+    return RowFormat::R10G10B10A2UNorm;
+  }
+  else if(fmt.type == ResourceFormatType::R11G11B10)
+  {
+    return RowFormat::R11G11B10;
+  }
+  else if(fmt.type == ResourceFormatType::R9G9B9E5)
+  {
+    return RowFormat::R9G9B9E5;
+  }
+
+  return RowFormat::Generic;
+}
+
+#if ENABLED(FORMAT_PACKING_SSE2)
+
+static inline __m128 SelectPS(__m128i mask, __m128 a, __m128 b)
+{
+  return _mm_or_ps(_mm_and_ps(_mm_castsi128_ps(mask), a), _mm_andnot_ps(_mm_castsi128_ps(mask), b));
+}
+
+static inline __m128 SwapRB(__m128 v)
+{
+  return _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 0, 1, 2));
+}
+
+// matches ConvertFromHalf() for four halfs stored in the low 16 bits of each lane, including
+// its canonicalisation of NaNs.
+static inline __m128 HalfToFloat_SSE2(__m128i h)
+{
+  const __m128i expmant = _mm_and_si128(h, _mm_set1_epi32(0x7fff));
+  const __m128i sign = _mm_slli_epi32(_mm_xor_si128(h, expmant), 16);
+
+  // rebias the exponent for normal values
+  __m128 normal =
+      _mm_castsi128_ps(_mm_add_epi32(_mm_slli_epi32(expmant, 13), _mm_set1_epi32(112 << 23)));
+
+  // subnormals are exactly mantissa * 2^-24, and we avoid generating float denormals
+  __m128 subnormal =
+      _mm_mul_ps(_mm_cvtepi32_ps(expmant), _mm_castsi128_ps(_mm_set1_epi32((127 - 24) << 23)));
+
+  const __m128i isSubnormal = _mm_cmplt_epi32(expmant, _mm_set1_epi32(0x0400));
+  const __m128i isInfNaN = _mm_cmpgt_epi32(expmant, _mm_set1_epi32(0x7bff));
+  const __m128i isNaN = _mm_cmpgt_epi32(expmant, _mm_set1_epi32(0x7c00));
+
+  __m128 ret = SelectPS(isSubnormal, subnormal, normal);
+  ret = SelectPS(isInfNaN, _mm_castsi128_ps(_mm_set1_epi32(0x7f800000)), ret);
+  ret = _mm_or_ps(ret, _mm_castsi128_ps(sign));
+  return SelectPS(isNaN, _mm_castsi128_ps(_mm_set1_epi32(0x7f800001)), ret);
+}
+
+// matches the per-channel decode in ConvertFromR11G11B10() for an unsigned float with a 5-bit
+// exponent and mantBits-bit mantissa.
+static inline __m128 SmallFloatToFloat_SSE2(__m128i mant, __m128i exp, int mantBits)
+{
+  const __m128i mantShift = _mm_cvtsi32_si128(23 - mantBits);
+
+  __m128i normal = _mm_or_si128(_mm_slli_epi32(_mm_add_epi32(exp, _mm_set1_epi32(112)), 23),
+                                _mm_sll_epi32(mant, mantShift));
+  __m128i infnan = _mm_or_si128(_mm_set1_epi32(0x7f800000), _mm_sll_epi32(mant, mantShift));
+  __m128 subnormal = _mm_mul_ps(_mm_cvtepi32_ps(mant),
+                                _mm_castsi128_ps(_mm_set1_epi32((127 - 14 - mantBits) << 23)));
+
+  __m128 ret = SelectPS(_mm_cmpeq_epi32(exp, _mm_setzero_si128()), subnormal,
+                        _mm_castsi128_ps(normal));
+  return SelectPS(_mm_cmpeq_epi32(exp, _mm_set1_epi32(0x1f)), _mm_castsi128_ps(infnan), ret);
+}
+
+static inline __m128i ExtractBits(__m128i packed, int shift, uint32_t mask)
+{
+  return _mm_and_si128(_mm_srl_epi32(packed, _mm_cvtsi32_si128(shift)), _mm_set1_epi32(int(mask)));
+}
+
+// SSE min/max return their second operand if either is NaN, so the operand order here is chosen to
+// match the scalar code. RDCCLAMP() lets NaN through unchanged:
+static inline __m128 ClampUNorm_SSE2(__m128 v)
+{
+  return _mm_min_ps(_mm_set1_ps(1.0f), _mm_max_ps(_mm_setzero_ps(), v));
+}
+
+// whereas ConvertToR10G10B10A2() tests against 1.0 first, so NaN becomes 1.0
+static inline __m128 ClampR10G10B10A2_SSE2(__m128 v)
+{
+  return _mm_min_ps(_mm_max_ps(_mm_setzero_ps(), v), _mm_set1_ps(1.0f));
+}
+
+// matches ConvertToHalf() for four floats, returning the half in the low 16 bits of each lane
+static inline __m128i FloatToHalf_SSE2(__m128 f)
+{
+  const __m128i bits = _mm_castps_si128(f);
+  const __m128i sign = _mm_and_si128(_mm_srli_epi32(bits, 16), _mm_set1_epi32(0x8000));
+  const __m128i exponent = _mm_sub_epi32(ExtractBits(bits, 23, 0xff), _mm_set1_epi32(127 - 15));
+  const __m128i mantissa = _mm_and_si128(bits, _mm_set1_epi32(0x007fffff));
+
+  // values that are subnormal (or zero) in half. ConvertToHalf() rounds these to nearest-even,
+  // which is exactly what the default rounding mode gives us from converting |f| * 2^24.
+  const __m128 absf = _mm_castsi128_ps(_mm_and_si128(bits, _mm_set1_epi32(0x7fffffff)));
+  const __m128i subnormal =
+      _mm_cvtps_epi32(_mm_mul_ps(absf, _mm_castsi128_ps(_mm_set1_epi32((127 + 24) << 23))));
+
+  // normal values, rounded to nearest-even. A carry out of the mantissa increments the exponent,
+  // and anything that ends up too large for half becomes infinity.
+  __m128i normal = _mm_or_si128(_mm_slli_epi32(exponent, 23), mantissa);
+  normal = _mm_add_epi32(normal, _mm_add_epi32(_mm_set1_epi32(0xfff), ExtractBits(mantissa, 13, 1)));
+  normal = _mm_srli_epi32(normal, 13);
+  const __m128i overflow = _mm_cmpgt_epi32(normal, _mm_set1_epi32(0x7bff));
+  normal = _mm_or_si128(_mm_andnot_si128(overflow, normal),
+                        _mm_and_si128(overflow, _mm_set1_epi32(0x7c00)));
+
+  // infinity stays infinity, NaNs keep the top mantissa bits but must stay NaN
+  const __m128i nanMantissa = _mm_srli_epi32(mantissa, 13);
+  const __m128i nanFixup = _mm_and_si128(
+      _mm_andnot_si128(_mm_cmpeq_epi32(mantissa, _mm_setzero_si128()),
+                       _mm_cmpeq_epi32(nanMantissa, _mm_setzero_si128())),
+      _mm_set1_epi32(1));
+  const __m128i infnan =
+      _mm_or_si128(_mm_set1_epi32(0x7c00), _mm_or_si128(nanMantissa, nanFixup));
+
+  const __m128i isSubnormal = _mm_cmplt_epi32(exponent, _mm_set1_epi32(1));
+  const __m128i isInfNaN = _mm_cmpeq_epi32(exponent, _mm_set1_epi32(0xff - (127 - 15)));
+
+  __m128i ret = _mm_or_si128(_mm_and_si128(isSubnormal, subnormal),
+                             _mm_andnot_si128(isSubnormal, normal));
+  ret = _mm_or_si128(_mm_and_si128(isInfNaN, infnan), _mm_andnot_si128(isInfNaN, ret));
+  return _mm_or_si128(ret, sign);
+}
+
+// pack the low 16 bits of each lane of a and b into one register
+static inline __m128i PackLow16(__m128i a, __m128i b)
+{
+  // sign-extend so the signed saturating pack keeps the bits as-is
+  a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+  b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+  return _mm_packs_epi32(a, b);
+}
+
+// matches the per-channel encode in ConvertToR11G11B10(), from a half and keeping the top
+// mantBits of its mantissa.
+static inline __m128i HalfToSmallFloat_SSE2(__m128i half, int mantBits)
+{
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i isNegative = _mm_cmpeq_epi32(_mm_and_si128(half, _mm_set1_epi32(0x8000)),
+                                             _mm_set1_epi32(0x8000));
+  __m128i mantissa = _mm_and_si128(half, _mm_set1_epi32(0x03ff));
+  const __m128i exponent = _mm_and_si128(half, _mm_set1_epi32(0x7c00));
+
+  const __m128i isInfNaN = _mm_cmpeq_epi32(exponent, _mm_set1_epi32(0x7c00));
+  const __m128i isNaN = _mm_andnot_si128(_mm_cmpeq_epi32(mantissa, zero), isInfNaN);
+
+  // NaNs get a full mantissa so they don't truncate to infinity
+  mantissa = _mm_or_si128(mantissa, _mm_and_si128(isNaN, _mm_set1_epi32(0x03ff)));
+
+  // negative values and negative infinity are clamped to 0, negative NaNs are left alone
+  const __m128i clampZero = _mm_andnot_si128(isNaN, isNegative);
+
+  __m128i ret = _mm_or_si128(_mm_srl_epi32(mantissa, _mm_cvtsi32_si128(10 - mantBits)),
+                             _mm_srli_epi32(exponent, 10 - mantBits));
+  return _mm_andnot_si128(clampZero, ret);
+}
+
+static size_t DecodeRow_SSE2(RowFormat rowFmt, bool swapRB, const byte *data, size_t count,
+                             FloatVector *out)
+{
+  size_t i = 0;
+
+  switch(rowFmt)
+  {
+    case RowFormat::Generic:
+    case RowFormat::RGBA8SRGB:
+    case RowFormat::Float32: break;
+    case RowFormat::RGBA8UNorm:
+    {
+      const __m128i zero = _mm_setzero_si128();
+      const __m128 scale = _mm_set1_ps(255.0f);
+
+      for(; i + 4 <= count; i += 4)
+      {
+        __m128i px = _mm_loadu_si128((const __m128i *)(data + i * 4));
+        __m128i lo = _mm_unpacklo_epi8(px, zero);
+        __m128i hi = _mm_unpackhi_epi8(px, zero);
+
+        __m128 v[4] = {
+            _mm_div_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero)), scale),
+            _mm_div_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero)), scale),
+            _mm_div_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero)), scale),
+            _mm_div_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero)), scale),
+        };
+
+        for(int p = 0; p < 4; p++)
+          _mm_storeu_ps(&out[i + p].x, swapRB ? SwapRB(v[p]) : v[p]);
+      }
+      break;
+    }
+    case RowFormat::RGBA16Float:
+    {
+      const __m128i zero = _mm_setzero_si128();
+
+      for(; i + 2 <= count; i += 2)
+      {
+        __m128i px = _mm_loadu_si128((const __m128i *)(data + i * 8));
+        _mm_storeu_ps(&out[i + 0].x, HalfToFloat_SSE2(_mm_unpacklo_epi16(px, zero)));
+        _mm_storeu_ps(&out[i + 1].x, HalfToFloat_SSE2(_mm_unpackhi_epi16(px, zero)));
+      }
+      break;
+    }
+    case RowFormat::R10G10B10A2UNorm:
+    case RowFormat::R11G11B10:
+    case RowFormat::R9G9B9E5:
+    {
+      // these are decoded four pixels at a time with one channel per register, then transposed
+      for(; i + 4 <= count; i += 4)
+      {
+        __m128i px = _mm_loadu_si128((const __m128i *)(data + i * 4));
+
+        __m128 r, g, b, a;
+
+        if(rowFmt == RowFormat::R10G10B10A2UNorm)
+        {
+          const __m128 scale = _mm_set1_ps(1023.0f);
+          r = _mm_div_ps(_mm_cvtepi32_ps(ExtractBits(px, 0, 0x3ff)), scale);
+          g = _mm_div_ps(_mm_cvtepi32_ps(ExtractBits(px, 10, 0x3ff)), scale);
+          b = _mm_div_ps(_mm_cvtepi32_ps(ExtractBits(px, 20, 0x3ff)), scale);
+          a = _mm_div_ps(_mm_cvtepi32_ps(ExtractBits(px, 30, 0x3)), _mm_set1_ps(3.0f));
+
+          if(swapRB)
+            std::swap(r, b);
+        }
+        else if(rowFmt == RowFormat::R11G11B10)
+        {
+          r = SmallFloatToFloat_SSE2(ExtractBits(px, 0, 0x3f), ExtractBits(px, 6, 0x1f), 6);
+          g = SmallFloatToFloat_SSE2(ExtractBits(px, 11, 0x3f), ExtractBits(px, 17, 0x1f), 6);
+          b = SmallFloatToFloat_SSE2(ExtractBits(px, 22, 0x1f), ExtractBits(px, 27, 0x1f), 5);
+          a = _mm_set1_ps(1.0f);
+        }
+        else
+        {
+          const __m128i exp = ExtractBits(px, 27, 0x1f);
+          const __m128i isInfNaN = _mm_cmpeq_epi32(exp, _mm_set1_epi32(0x1f));
+          const __m128 expScale =
+              _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(exp, _mm_set1_epi32(112)), 23));
+          const __m128 mantScale = _mm_set1_ps(512.0f);
+
+          __m128i mant[3] = {
+              ExtractBits(px, 0, 0x1ff),
+              ExtractBits(px, 9, 0x1ff),
+              ExtractBits(px, 18, 0x1ff),
+          };
+          __m128 rgb[3];
+
+          for(int c = 0; c < 3; c++)
+          {
+            __m128 finite = _mm_mul_ps(expScale, _mm_div_ps(_mm_cvtepi32_ps(mant[c]), mantScale));
+            __m128i infnan = _mm_or_si128(_mm_set1_epi32(0x7f800000), _mm_slli_epi32(mant[c], 14));
+            rgb[c] = SelectPS(isInfNaN, _mm_castsi128_ps(infnan), finite);
+          }
+
+          r = rgb[0];
+          g = rgb[1];
+          b = rgb[2];
+          a = _mm_set1_ps(1.0f);
+        }
+
+        _MM_TRANSPOSE4_PS(r, g, b, a);
+
+        _mm_storeu_ps(&out[i + 0].x, r);
+        _mm_storeu_ps(&out[i + 1].x, g);
+        _mm_storeu_ps(&out[i + 2].x, b);
+        _mm_storeu_ps(&out[i + 3].x, a);
+      }
+      break;
+    }
+  }
+
+  return i;
+}
+
+static size_t EncodeRow_SSE2(RowFormat rowFmt, bool swapRB, const FloatVector *in, size_t count,
+                             byte *data)
+{
+  size_t i = 0;
+
+  switch(rowFmt)
+  {
+    case RowFormat::RGBA8UNorm:
+    {
+      const __m128 scale = _mm_set1_ps(255.0f);
+      const __m128 half = _mm_set1_ps(0.5f);
+
+      for(; i + 4 <= count; i += 4)
+      {
+        __m128i px[4];
+        for(int p = 0; p < 4; p++)
+        {
+          // EncodeFormattedComponents() writes regular formats in component order regardless of
+          // BGRA ordering, so we don't swap here
+          __m128 v = ClampUNorm_SSE2(_mm_loadu_ps(&in[i + p].x));
+          px[p] = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(v, scale), half));
+        }
+
+        __m128i packed =
+            _mm_packus_epi16(_mm_packs_epi32(px[0], px[1]), _mm_packs_epi32(px[2], px[3]));
+        _mm_storeu_si128((__m128i *)(data + i * 4), packed);
+      }
+      break;
+    }
+    case RowFormat::R10G10B10A2UNorm:
+    {
+      for(; i + 4 <= count; i += 4)
+      {
+        __m128 r = _mm_loadu_ps(&in[i + 0].x);
+        __m128 g = _mm_loadu_ps(&in[i + 1].x);
+        __m128 b = _mm_loadu_ps(&in[i + 2].x);
+        __m128 a = _mm_loadu_ps(&in[i + 3].x);
+
+        _MM_TRANSPOSE4_PS(r, g, b, a);
+
+        if(swapRB)
+          std::swap(r, b);
+
+        const __m128 scale = _mm_set1_ps(1023.0f);
+
+        __m128i ri = _mm_cvttps_epi32(_mm_mul_ps(ClampR10G10B10A2_SSE2(r), scale));
+        __m128i gi = _mm_cvttps_epi32(_mm_mul_ps(ClampR10G10B10A2_SSE2(g), scale));
+        __m128i bi = _mm_cvttps_epi32(_mm_mul_ps(ClampR10G10B10A2_SSE2(b), scale));
+        __m128i ai = _mm_cvttps_epi32(_mm_mul_ps(ClampR10G10B10A2_SSE2(a), _mm_set1_ps(3.0f)));
+
+        __m128i packed = _mm_or_si128(_mm_or_si128(ri, _mm_slli_epi32(gi, 10)),
+                                      _mm_or_si128(_mm_slli_epi32(bi, 20), _mm_slli_epi32(ai, 30)));
+        _mm_storeu_si128((__m128i *)(data + i * 4), packed);
+      }
+      break;
+    }
+    case RowFormat::RGBA16Float:
+    {
+      for(; i + 2 <= count; i += 2)
+      {
+        __m128i a = FloatToHalf_SSE2(_mm_loadu_ps(&in[i + 0].x));
+        __m128i b = FloatToHalf_SSE2(_mm_loadu_ps(&in[i + 1].x));
+        _mm_storeu_si128((__m128i *)(data + i * 8), PackLow16(a, b));
+      }
+      break;
+    }
+    case RowFormat::R11G11B10:
+    {
+      for(; i + 4 <= count; i += 4)
+      {
+        __m128 r = _mm_loadu_ps(&in[i + 0].x);
+        __m128 g = _mm_loadu_ps(&in[i + 1].x);
+        __m128 b = _mm_loadu_ps(&in[i + 2].x);
+        __m128 a = _mm_loadu_ps(&in[i + 3].x);
+
+        _MM_TRANSPOSE4_PS(r, g, b, a);
+
+        __m128i ri = HalfToSmallFloat_SSE2(FloatToHalf_SSE2(r), 6);
+        __m128i gi = HalfToSmallFloat_SSE2(FloatToHalf_SSE2(g), 6);
+        __m128i bi = HalfToSmallFloat_SSE2(FloatToHalf_SSE2(b), 5);
+
+        __m128i packed =
+            _mm_or_si128(ri, _mm_or_si128(_mm_slli_epi32(gi, 11), _mm_slli_epi32(bi, 22)));
+        _mm_storeu_si128((__m128i *)(data + i * 4), packed);
+      }
+      break;
+    }
+    default: break;
+  }
+
+  return i;
+}
+
+#endif    // ENABLED(FORMAT_PACKING_SSE2)
+
+void DecodeFormattedComponentsRow(const ResourceFormat &fmt, const byte *data, uint32_t stride,
+                                  size_t count, FloatVector *out, bool *success)
+{
+  if(success)
+    *success = true;
+
+  const RowFormat rowFmt = GetRowFormat(fmt, stride);
+
+  size_t i = 0;
+
+#if ENABLED(FORMAT_PACKING_SSE2)
+  i = DecodeRow_SSE2(rowFmt, fmt.BGRAOrder(), data, count, out);
+#endif
+
+  if(rowFmt == RowFormat::RGBA8SRGB)
+  {
+    const bool swapRB = fmt.BGRAOrder();
+    for(; i < count; i++)
+    {
+      const byte *px = data + i * 4;
+      out[i].x = ConvertFromSRGB8(px[swapRB ? 2 : 0]);
+      out[i].y = ConvertFromSRGB8(px[1]);
+      out[i].z = ConvertFromSRGB8(px[swapRB ? 0 : 2]);
+      out[i].w = float(px[3]) / 255.0f;
+    }
+  }
+
+  if(rowFmt == RowFormat::Float32)
+  {
+    // components past compCount are 0, except alpha which defaults to 1
+    const FloatVector def(0.0f, 0.0f, 0.0f, 1.0f);
+    const size_t compSize = fmt.compCount * sizeof(float);
+    for(; i < count; i++)
+    {
+      out[i] = def;
+      memcpy(&out[i].x, data + i * stride, compSize);
+    }
+  }
+
+  for(; i < count; i++)
+  {
+    bool pixelSuccess = true;
+    out[i] = DecodeFormattedComponents(fmt, data + i * stride, &pixelSuccess);
+    if(success && !pixelSuccess)
+      *success = false;
+  }
+}
+
+void DecodePixelDataRow(const ResourceFormat &fmt, const byte *data, uint32_t stride, size_t count,
+                        PixelValue *out, bool *success)
+{
+  if(success)
+    *success = true;
+
+  if(GetRowFormat(fmt, stride) != RowFormat::Generic)
+  {
+    // all of the row kernels are for float formats, where DecodePixelData() produces the same
+    // floats as DecodeFormattedComponents(). Decode in chunks through a small local buffer.
+    FloatVector chunk[64];
+
+    for(size_t i = 0; i < count; i += ARRAY_COUNT(chunk))
+    {
+      const size_t num = RDCMIN(count - i, ARRAY_COUNT(chunk));
+      DecodeFormattedComponentsRow(fmt, data + i * stride, stride, num, chunk);
+
+      for(size_t c = 0; c < num; c++)
+        out[i + c].floatValue = {chunk[c].x, chunk[c].y, chunk[c].z, chunk[c].w};
+    }
+
+    return;
+  }
+
+  for(size_t i = 0; i < count; i++)
+  {
+    bool pixelSuccess = true;
+    DecodePixelData(fmt, data + i * stride, out[i], &pixelSuccess);
+    if(success && !pixelSuccess)
+      *success = false;
+  }
+}
+
+void EncodeFormattedComponentsRow(const ResourceFormat &fmt, const FloatVector *in, size_t count,
+                                  byte *data, uint32_t stride, bool *success)
+{
+  if(success)
+    *success = true;
+
+  size_t i = 0;
+
+#if ENABLED(FORMAT_PACKING_SSE2)
+  i = EncodeRow_SSE2(GetRowFormat(fmt, stride), fmt.BGRAOrder(), in, count, data);
+#endif
+
+  for(; i < count; i++)
+  {
+    bool pixelSuccess = true;
+    EncodeFormattedComponents(fmt, in[i], data + i * stride, &pixelSuccess);
+    if(success && !pixelSuccess)
+      *success = false;
+  }
+}
+
+void AccumulateFiniteMinMax(const FloatVector *in, size_t count, FloatVector &minval,
+                            FloatVector &maxval)
+{
+  size_t i = 0;
+
+#if ENABLED(FORMAT_PACKING_SSE2)
+  __m128 mn = _mm_loadu_ps(&minval.x);
+  __m128 mx = _mm_loadu_ps(&maxval.x);
+  const __m128 zero = _mm_setzero_ps();
+
+  for(; i < count; i++)
+  {
+    const __m128 v = _mm_loadu_ps(&in[i].x);
+
+    // v - v is 0 for finite values and NaN for infinities and NaNs, which compares false
+    const __m128i finite = _mm_castps_si128(_mm_cmpeq_ps(_mm_sub_ps(v, v), zero));
+
+    mn = SelectPS(finite, _mm_min_ps(mn, v), mn);
+    mx = SelectPS(finite, _mm_max_ps(mx, v), mx);
+  }
+
+  _mm_storeu_ps(&minval.x, mn);
+  _mm_storeu_ps(&maxval.x, mx);
+#endif
+
+  float *mnf = &minval.x;
+  float *mxf = &maxval.x;
+
+  for(; i < count; i++)
+  {
+    const float *v = &in[i].x;
+    for(int c = 0; c < 4; c++)
+    {
+      if(RDCISFINITE(v[c]))
+      {
+        mnf[c] = RDCMIN(mnf[c], v[c]);
+        mxf[c] = RDCMAX(mxf[c], v[c]);
+      }
+    }
+  }
+}
+
 #if ENABLED(ENABLE_UNIT_TESTS)
 
 #undef None
 
 #include "catch/catch.hpp"
 #include "common/formatting.h"
+#include "common/timing.h"
 
 template <>
 rdcstr DoStringise(const FloatVector &el)
@@ -1603,4 +2164,218 @@ TEST_CASE("Check format conversion", "[format]")
   };
 }
 
+TEST_CASE("Check row format conversion matches per-pixel conversion", "[format]")
+{
+  // odd count so that we exercise the scalar tail after the vectorised kernels
+  const size_t count = 1027;
+
+  uint32_t seed = 0x1234567;
+  auto rand32 = [&seed]() {
+    seed = seed * 1664525U + 1013904223U;
+    return seed;
+  };
+
+  bytebuf packed;
+  packed.resize(count * 8);
+
+  rdcarray<FloatVector> rowDecoded, pixelDecoded;
+  rowDecoded.resize(count);
+  pixelDecoded.resize(count);
+
+  rdcarray<ResourceFormat> formats;
+
+  {
+    ResourceFormat fmt;
+    fmt.type = ResourceFormatType::Regular;
+    fmt.compCount = 4;
+    fmt.compByteWidth = 1;
+    fmt.compType = CompType::UNorm;
+    formats.push_back(fmt);
+    fmt.SetBGRAOrder(true);
+    formats.push_back(fmt);
+    fmt.compType = CompType::UNormSRGB;
+    formats.push_back(fmt);
+    fmt.SetBGRAOrder(false);
+    formats.push_back(fmt);
+
+    fmt.compByteWidth = 2;
+    fmt.compType = CompType::Float;
+    formats.push_back(fmt);
+
+    fmt.compByteWidth = 1;
+    fmt.compCount = 1;
+    formats.push_back(fmt);
+
+    fmt.compCount = 4;
+    fmt.compByteWidth = 4;
+    fmt.type = ResourceFormatType::R10G10B10A2;
+    fmt.compType = CompType::UNorm;
+    formats.push_back(fmt);
+    fmt.SetBGRAOrder(true);
+    formats.push_back(fmt);
+    fmt.SetBGRAOrder(false);
+    fmt.compType = CompType::SNorm;
+    formats.push_back(fmt);
+
+    fmt.compCount = 3;
+    fmt.compType = CompType::Float;
+    fmt.type = ResourceFormatType::R11G11B10;
+    formats.push_back(fmt);
+    fmt.type = ResourceFormatType::R9G9B9E5;
+    formats.push_back(fmt);
+  }
+
+  for(const ResourceFormat &fmt : formats)
+  {
+    const uint32_t stride = fmt.ElementSize();
+
+    INFO(fmt.Name());
+
+    SECTION(("Decode " + fmt.Name()).c_str())
+    {
+      // fill with random bits, and for half floats also test every possible value
+      for(size_t i = 0; i < packed.size(); i += 4)
+      {
+        uint32_t val = rand32();
+        memcpy(packed.data() + i, &val, sizeof(val));
+      }
+
+      rdcarray<uint16_t> allHalfs;
+      if(fmt.compByteWidth == 2)
+      {
+        allHalfs.resize(65536 + 4);
+        for(uint32_t i = 0; i < allHalfs.size(); i++)
+          allHalfs[i] = i & 0xffff;
+      }
+
+      const byte *src = allHalfs.empty() ? packed.data() : (const byte *)allHalfs.data();
+      const size_t num = allHalfs.empty() ? count : allHalfs.size() / 4;
+
+      rowDecoded.resize(num);
+      pixelDecoded.resize(num);
+
+      bool rowSuccess = false, pixelSuccess = false;
+      DecodeFormattedComponentsRow(fmt, src, stride, num, rowDecoded.data(), &rowSuccess);
+      for(size_t i = 0; i < num; i++)
+        pixelDecoded[i] = DecodeFormattedComponents(fmt, src + i * stride, &pixelSuccess);
+
+      CHECK(rowSuccess == pixelSuccess);
+
+      for(size_t i = 0; i < num; i++)
+      {
+        INFO(i);
+        CHECK(memcmp(&rowDecoded[i], &pixelDecoded[i], sizeof(FloatVector)) == 0);
+      }
+
+      rdcarray<PixelValue> rowValues;
+      rowValues.resize(num);
+      DecodePixelDataRow(fmt, src, stride, num, rowValues.data(), &rowSuccess);
+
+      CHECK(rowSuccess == pixelSuccess);
+
+      for(size_t i = 0; i < num; i++)
+      {
+        INFO(i);
+        PixelValue pixelValue;
+        DecodePixelData(fmt, src + i * stride, pixelValue);
+        CHECK(memcmp(&rowValues[i], &pixelValue, sizeof(PixelValue)) == 0);
+      }
+    };
+
+    SECTION(("Encode " + fmt.Name()).c_str())
+    {
+      rdcarray<FloatVector> input;
+      input.resize(count);
+
+      // special values that need to be handled identically, including values that are subnormal
+      // or out of range for half floats.
+      const float specials[] = {
+          NAN,     -NAN,     INFINITY, -INFINITY, 0.0f,     -0.0f,   1.0f,     -1.0f,
+          65504.0f, 65520.0f, 1.0e10f,  -1.0e10f,  6.0e-5f,  6.1e-5f, 3.0e-8f,  2.9e-8f,
+          1.0e-7f, -1.0e-7f,  1.0e-40f, FLT_MAX,   FLT_MIN,  0.5f,    1.00049f, 2047.5f,
+      };
+
+      // values mostly in [0,1] but some out of range to check clamping
+      for(size_t i = 0; i < count; i++)
+      {
+        float *comp = &input[i].x;
+        for(int c = 0; c < 4; c++)
+        {
+          uint32_t r = rand32();
+          if((r & 0x7) == 0)
+            comp[c] = specials[(r >> 3) % ARRAY_COUNT(specials)];
+          else
+            comp[c] = float(rand32() % 140000) / 100000.0f - 0.2f;
+        }
+      }
+
+      bytebuf rowEncoded, pixelEncoded;
+      rowEncoded.resize(count * stride);
+      pixelEncoded.resize(count * stride);
+
+      EncodeFormattedComponentsRow(fmt, input.data(), count, rowEncoded.data(), stride);
+      for(size_t i = 0; i < count; i++)
+        EncodeFormattedComponents(fmt, input[i], pixelEncoded.data() + i * stride);
+
+      CHECK(rowEncoded == pixelEncoded);
+    };
+  }
+}
+
+TEST_CASE("Benchmark row format conversion", "[.][format][benchmark]")
+{
+  const size_t count = 4096 * 1024;
+
+  bytebuf packed;
+  packed.resize(count * 8);
+  for(size_t i = 0; i < packed.size(); i++)
+    packed[i] = byte((i * 2654435761U) >> 13);
+
+  rdcarray<FloatVector> decoded;
+  decoded.resize(count);
+
+  const rdcpair<ResourceFormatType, CompType> formats[] = {
+      {ResourceFormatType::Regular, CompType::UNorm},
+      {ResourceFormatType::Regular, CompType::UNormSRGB},
+      {ResourceFormatType::Regular, CompType::Float},
+      {ResourceFormatType::R10G10B10A2, CompType::UNorm},
+      {ResourceFormatType::R11G11B10, CompType::Float},
+      {ResourceFormatType::R9G9B9E5, CompType::Float},
+  };
+
+  for(const rdcpair<ResourceFormatType, CompType> &f : formats)
+  {
+    ResourceFormat fmt;
+    fmt.type = f.first;
+    fmt.compType = f.second;
+    fmt.compCount = f.first == ResourceFormatType::Regular ? 4 : 3;
+    fmt.compByteWidth = f.second == CompType::Float && f.first == ResourceFormatType::Regular ? 2 : 1;
+    if(f.first != ResourceFormatType::Regular)
+      fmt.compByteWidth = 4;
+
+    const uint32_t stride = fmt.ElementSize();
+
+    PerformanceTimer timer;
+    for(size_t i = 0; i < count; i++)
+      decoded[i] = DecodeFormattedComponents(fmt, packed.data() + i * stride);
+    double pixelDecode = timer.GetMilliseconds();
+
+    timer.Restart();
+    DecodeFormattedComponentsRow(fmt, packed.data(), stride, count, decoded.data());
+    double rowDecode = timer.GetMilliseconds();
+
+    timer.Restart();
+    for(size_t i = 0; i < count; i++)
+      EncodeFormattedComponents(fmt, decoded[i], packed.data() + i * stride);
+    double pixelEncode = timer.GetMilliseconds();
+
+    timer.Restart();
+    EncodeFormattedComponentsRow(fmt, decoded.data(), count, packed.data(), stride);
+    double rowEncode = timer.GetMilliseconds();
+
+    RDCLOG("%s: decode %.2f ms -> %.2f ms, encode %.2f ms -> %.2f ms", fmt.Name().c_str(),
+           pixelDecode, rowDecode, pixelEncode, rowEncode);
+  }
+}
+
 #endif
@@ -186,3 +186,17 @@ void EncodeFormattedComponents(const ResourceFormat &fmt, FloatVector v, byte *d
 
 void DecodePixelData(const ResourceFormat &srcFmt, const byte *data, PixelValue &out,
                      bool *success = NULL);
+
+// decode/encode a row of count pixels, each stride bytes apart. The results are identical to
+// calling DecodeFormattedComponents/EncodeFormattedComponents on each pixel, but the most common
+// formats are converted with vectorised kernels.
+void DecodeFormattedComponentsRow(const ResourceFormat &fmt, const byte *data, uint32_t stride,
+                                  size_t count, FloatVector *out, bool *success = NULL);
+void DecodePixelDataRow(const ResourceFormat &fmt, const byte *data, uint32_t stride, size_t count,
+                        PixelValue *out, bool *success = NULL);
+void EncodeFormattedComponentsRow(const ResourceFormat &fmt, const FloatVector *in, size_t count,
+                                  byte *data, uint32_t stride, bool *success = NULL);
+
+// expand minval/maxval per-component to include count values, skipping any infinities or NaNs.
+void AccumulateFiniteMinMax(const FloatVector *in, size_t count, FloatVector &minval,
+                            FloatVector &maxval);
@@ -158,6 +158,15 @@ void DetachThread(ThreadHandle handle);
 void CloseThread(ThreadHandle handle);
 void Sleep(uint32_t milliseconds);
 
+// give up the rest of this thread's timeslice to any other runnable thread
+void YieldCurrentThread();
+
+// block the calling thread for as long as *addr == value, until woken by WakeAddress. Spurious
+// wakeups are possible so callers must re-check their condition. On platforms without a native
+// address-wait primitive this yields instead of sleeping.
+void WaitOnAddress(int32_t *addr, int32_t value);
+void WakeAddress(int32_t *addr);
+
 // kind of windows specific, to handle this case:
 // http://blogs.msdn.com/b/oldnewthing/archive/2013/11/05/10463645.aspx
 void KeepModuleAlive();
@@ -234,6 +243,8 @@ int64_t Inc64(int64_t *i);
 int64_t Dec64(int64_t *i);
 int64_t ExchAdd64(int64_t *i, int64_t a);
 int32_t CmpExch32(int32_t *dest, int32_t oldVal, int32_t newVal);
+int32_t Exch32(int32_t *dest, int32_t newVal);
+int32_t Load32(const int32_t *src);
 };
 
 namespace Callstack
@@ -24,6 +24,8 @@
 
 #include "os/os_specific.h"
 
+#include <linux/futex.h>
+#include <sys/syscall.h>
 #include <time.h>
 #include <unistd.h>
 
@@ -42,3 +44,13 @@ uint64_t Timing::GetTick()
 void Threading::SetCurrentThreadName(const rdcstr &name)
 {
 }
+
+void Threading::WaitOnAddress(int32_t *addr, int32_t value)
+{
+  syscall(SYS_futex, addr, FUTEX_WAIT_PRIVATE, value, NULL, NULL, 0);
+}
+
+void Threading::WakeAddress(int32_t *addr)
+{
+  syscall(SYS_futex, addr, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+}
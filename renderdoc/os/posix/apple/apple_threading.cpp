@@ -24,8 +24,16 @@
 
 #include "os/os_specific.h"
 
+#include <errno.h>
 #include <mach/mach_time.h>
 
+// private but stable libsystem_kernel entry points, used by libc++ and others for futex-like
+// waiting. os_sync_wait_on_address is the public equivalent but needs macOS 14.4.
+extern "C" int __ulock_wait(uint32_t operation, void *addr, uint64_t value, uint32_t timeout_us);
+extern "C" int __ulock_wake(uint32_t operation, void *addr, uint64_t wake_value);
+
+#define UL_COMPARE_AND_WAIT 1
+
 double Timing::GetTickFrequency()
 {
   mach_timebase_info_data_t timeInfo;
@@ -44,3 +52,16 @@ uint64_t Timing::GetTick()
 void Threading::SetCurrentThreadName(const rdcstr &name)
 {
 }
+
+void Threading::WaitOnAddress(int32_t *addr, int32_t value)
+{
+  // returns immediately if *addr != value. Spurious wakeups are handled by the caller re-checking
+  int ret = __ulock_wait(UL_COMPARE_AND_WAIT, addr, (uint64_t)(uint32_t)value, 0);
+  if(ret < 0 && errno != EINTR && errno != EFAULT && *(volatile int32_t *)addr == value)
+    Threading::YieldCurrentThread();
+}
+
+void Threading::WakeAddress(int32_t *addr)
+{
+  __ulock_wake(UL_COMPARE_AND_WAIT, addr, 0);
+}
@@ -27,6 +27,11 @@
 #include <time.h>
 #include <unistd.h>
 
+#if defined(__FreeBSD__)
+#include <sys/types.h>
+#include <sys/umtx.h>
+#endif
+
 double Timing::GetTickFrequency()
 {
   return 1000000.0;
@@ -42,3 +47,32 @@ uint64_t Timing::GetTick()
 void Threading::SetCurrentThreadName(const rdcstr &name)
 {
 }
+
+#if defined(__FreeBSD__)
+
+void Threading::WaitOnAddress(int32_t *addr, int32_t value)
+{
+  // returns immediately if *addr != value. Spurious wakeups are handled by the caller re-checking
+  _umtx_op(addr, UMTX_OP_WAIT_UINT_PRIVATE, (u_long)(uint32_t)value, NULL, NULL);
+}
+
+void Threading::WakeAddress(int32_t *addr)
+{
+  _umtx_op(addr, UMTX_OP_WAKE_PRIVATE, 1, NULL, NULL);
+}
+
+#else
+
+// other BSDs don't have a common futex-like primitive, so fall back to yielding. With no sleeping
+// waiters there's nothing to wake.
+void Threading::WaitOnAddress(int32_t *addr, int32_t value)
+{
+  if(*(volatile int32_t *)addr == value)
+    Threading::YieldCurrentThread();
+}
+
+void Threading::WakeAddress(int32_t *addr)
+{
+}
+
+#endif
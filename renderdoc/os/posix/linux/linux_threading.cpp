@@ -24,7 +24,9 @@
 
 #include "os/os_specific.h"
 
+#include <linux/futex.h>
 #include <sys/prctl.h>
+#include <sys/syscall.h>
 #include <time.h>
 #include <unistd.h>
 
@@ -44,3 +46,13 @@ void Threading::SetCurrentThreadName(const rdcstr &name)
 {
   prctl(PR_SET_NAME, (unsigned long)name.c_str(), 0, 0, 0);
 }
+
+void Threading::WaitOnAddress(int32_t *addr, int32_t value)
+{
+  syscall(SYS_futex, addr, FUTEX_WAIT_PRIVATE, value, NULL, NULL, 0);
+}
+
+void Threading::WakeAddress(int32_t *addr)
+{
+  syscall(SYS_futex, addr, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+}
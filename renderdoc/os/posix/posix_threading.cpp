@@ -22,6 +22,7 @@
  * THE SOFTWARE.
  ******************************************************************************/
 
+#include <sched.h>
 #include <time.h>
 #include <unistd.h>
 #include "common/common.h"
@@ -70,6 +71,16 @@ int32_t CmpExch32(int32_t *dest, int32_t oldVal, int32_t newVal)
 {
   return __sync_val_compare_and_swap(dest, oldVal, newVal);
 }
+
+int32_t Exch32(int32_t *dest, int32_t newVal)
+{
+  return __atomic_exchange_n(dest, newVal, __ATOMIC_SEQ_CST);
+}
+
+int32_t Load32(const int32_t *src)
+{
+  return __atomic_load_n(src, __ATOMIC_ACQUIRE);
+}
 };
 
 namespace Threading
@@ -303,4 +314,9 @@ void Sleep(uint32_t milliseconds)
 {
   usleep(milliseconds * 1000);
 }
+
+void YieldCurrentThread()
+{
+  sched_yield();
+}
 };
@@ -83,6 +83,17 @@ int32_t CmpExch32(int32_t *dest, int32_t oldVal, int32_t newVal)
 {
   return (int32_t)InterlockedCompareExchange((volatile LONG *)dest, newVal, oldVal);
 }
+
+int32_t Exch32(int32_t *dest, int32_t newVal)
+{
+  return (int32_t)InterlockedExchange((volatile LONG *)dest, newVal);
+}
+
+int32_t Load32(const int32_t *src)
+{
+  // aligned 32-bit reads are atomic, volatile stops the compiler caching the value
+  return *(const volatile int32_t *)src;
+}
 };
 
 namespace Threading
@@ -368,4 +379,64 @@ void Sleep(uint32_t milliseconds)
 {
   ::Sleep((DWORD)milliseconds);
 }
+
+void YieldCurrentThread()
+{
+  SwitchToThread();
+}
+
+// WaitOnAddress is only available from Windows 8 onwards, so look it up at runtime and fall back
+// to yielding when it's not present.
+typedef BOOL(WINAPI *PFN_WaitOnAddress)(volatile VOID *Address, PVOID CompareAddress,
+                                        SIZE_T AddressSize, DWORD dwMilliseconds);
+typedef VOID(WINAPI *PFN_WakeByAddressSingle)(PVOID Address);
+
+static PFN_WaitOnAddress dynWaitOnAddress = NULL;
+static PFN_WakeByAddressSingle dynWakeByAddressSingle = NULL;
+
+static void InitWaitOnAddress()
+{
+  static bool init = false;
+  if(init)
+    return;
+
+  HMODULE mod = GetModuleHandleA("api-ms-win-core-synch-l1-2-0.dll");
+  if(!mod)
+    mod = LoadLibraryA("api-ms-win-core-synch-l1-2-0.dll");
+
+  if(mod)
+  {
+    PFN_WakeByAddressSingle wake =
+        (PFN_WakeByAddressSingle)GetProcAddress(mod, "WakeByAddressSingle");
+    PFN_WaitOnAddress wait = (PFN_WaitOnAddress)GetProcAddress(mod, "WaitOnAddress");
+
+    // only use the pair together, a waiter that's never woken would hang
+    if(wait && wake)
+    {
+      dynWakeByAddressSingle = wake;
+      dynWaitOnAddress = wait;
+    }
+  }
+
+  // racing threads will all resolve the same pointers so this is benign
+  init = true;
+}
+
+void WaitOnAddress(int32_t *addr, int32_t value)
+{
+  InitWaitOnAddress();
+
+  if(dynWaitOnAddress)
+    dynWaitOnAddress(addr, &value, sizeof(value), INFINITE);
+  else if(*(volatile int32_t *)addr == value)
+    SwitchToThread();
+}
+
+void WakeAddress(int32_t *addr)
+{
+  InitWaitOnAddress();
+
+  if(dynWakeByAddressSingle)
+    dynWakeByAddressSingle(addr);
+}
 };
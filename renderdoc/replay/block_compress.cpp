@@ -0,0 +1,340 @@
+/******************************************************************************
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019-2024 Baldur Karlsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#include "block_compress.h"
+#include "common/common.h"
+#include "common/threading.h"
+#include "maths/formatpacking.h"
+#include "maths/half_convert.h"
+
+#if DISABLED(RDOC_ANDROID)
+#include "compressonator/CMP_Core.h"
+#endif
+
+static bool IsBCFormat(ResourceFormatType type)
+{
+  return type == ResourceFormatType::BC1 || type == ResourceFormatType::BC2 ||
+         type == ResourceFormatType::BC3 || type == ResourceFormatType::BC4 ||
+         type == ResourceFormatType::BC5 || type == ResourceFormatType::BC6 ||
+         type == ResourceFormatType::BC7;
+}
+
+bool CanBlockCompress(ResourceFormatType type)
+{
+#if ENABLED(RDOC_ANDROID)
+  return false;
+#else
+  return IsBCFormat(type);
+#endif
+}
+
+uint32_t GetBlockCompressedSize(ResourceFormatType type)
+{
+  return type == ResourceFormatType::BC1 || type == ResourceFormatType::BC4 ? 8 : 16;
+}
+
+#if ENABLED(RDOC_ANDROID)
+
+bool BlockCompress(const ResourceFormat &fmt, QualityHint quality, const FloatVector *pixels,
+                   uint32_t width, uint32_t height, bytebuf &out)
+{
+  RDCERR("Block compression to %s not supported on android", fmt.Name().c_str());
+  return false;
+}
+
+#else
+
+static float GetEncoderQuality(QualityHint quality)
+{
+  switch(quality)
+  {
+    case QualityHint::Fastest: return 0.0f;
+    // compressonator's own default
+    case QualityHint::DontCare: return 0.05f;
+    case QualityHint::Nicest: return 1.0f;
+  }
+
+  return 0.05f;
+}
+
+// owns one compressonator options object. These must be created before any encoding starts, as
+// creating BC7 options lazily initialises global tables which is not thread safe.
+struct BlockCompressOptions
+{
+  BlockCompressOptions(ResourceFormatType t, float quality) : type(t)
+  {
+    switch(type)
+    {
+      case ResourceFormatType::BC1:
+        CreateOptionsBC1(&options);
+        SetQualityBC1(options, quality);
+        break;
+      case ResourceFormatType::BC2:
+        CreateOptionsBC2(&options);
+        SetQualityBC2(options, quality);
+        break;
+      case ResourceFormatType::BC3:
+        CreateOptionsBC3(&options);
+        SetQualityBC3(options, quality);
+        break;
+      case ResourceFormatType::BC4:
+        CreateOptionsBC4(&options);
+        SetQualityBC4(options, quality);
+        break;
+      case ResourceFormatType::BC5:
+        CreateOptionsBC5(&options);
+        SetQualityBC5(options, quality);
+        break;
+      case ResourceFormatType::BC6:
+        CreateOptionsBC6(&options);
+        SetQualityBC6(options, quality);
+        break;
+      case ResourceFormatType::BC7:
+        CreateOptionsBC7(&options);
+        SetQualityBC7(options, quality);
+        break;
+      default: break;
+    }
+  }
+
+  ~BlockCompressOptions()
+  {
+    switch(type)
+    {
+      case ResourceFormatType::BC1: DestroyOptionsBC1(options); break;
+      case ResourceFormatType::BC2: DestroyOptionsBC2(options); break;
+      case ResourceFormatType::BC3: DestroyOptionsBC3(options); break;
+      case ResourceFormatType::BC4: DestroyOptionsBC4(options); break;
+      case ResourceFormatType::BC5: DestroyOptionsBC5(options); break;
+      case ResourceFormatType::BC6: DestroyOptionsBC6(options); break;
+      case ResourceFormatType::BC7: DestroyOptionsBC7(options); break;
+      default: break;
+    }
+  }
+
+  ResourceFormatType type;
+  void *options = NULL;
+};
+
+static byte ToUNorm8(float f, bool srgb)
+{
+  if(srgb)
+    f = ConvertLinearToSRGB(f);
+
+  // written this way so NaN goes to 0
+  if(!(f > 0.0f))
+    return 0;
+  if(f >= 1.0f)
+    return 255;
+  return byte(f * 255.0f + 0.5f);
+}
+
+bool BlockCompress(const ResourceFormat &fmt, QualityHint quality, const FloatVector *pixels,
+                   uint32_t width, uint32_t height, bytebuf &out)
+{
+  if(!IsBCFormat(fmt.type))
+  {
+    RDCERR("Can't block compress to %s", fmt.Name().c_str());
+    return false;
+  }
+
+  const ResourceFormatType type = fmt.type;
+  const bool srgb = fmt.compType == CompType::UNormSRGB;
+
+  const uint32_t blocksWide = RDCMAX(1U, (width + 3) / 4);
+  const uint32_t blocksHigh = RDCMAX(1U, (height + 3) / 4);
+  const uint32_t blockSize = GetBlockCompressedSize(type);
+
+  out.resize(size_t(blocksWide) * blocksHigh * blockSize);
+
+  if(width == 0 || height == 0)
+  {
+    out.clear();
+    return true;
+  }
+
+  BlockCompressOptions opts(type, GetEncoderQuality(quality));
+
+  Threading::ParallelFor(blocksHigh, [&](uint32_t by) {
+    // large enough for 4x4 RGBA8 as well as 4x4 RGB16F. BC5 uses the second half for its second
+    // channel
+    byte scratch[4 * 4 * 4 * sizeof(uint16_t)];
+    uint16_t *scratchHalf = (uint16_t *)scratch;
+
+    byte *dst = out.data() + size_t(by) * blocksWide * blockSize;
+
+    for(uint32_t bx = 0; bx < blocksWide; bx++)
+    {
+      for(uint32_t py = 0; py < 4; py++)
+      {
+        const uint32_t y = RDCMIN(by * 4 + py, height - 1);
+
+        for(uint32_t px = 0; px < 4; px++)
+        {
+          const uint32_t x = RDCMIN(bx * 4 + px, width - 1);
+          const FloatVector &pix = pixels[size_t(y) * width + x];
+          const uint32_t idx = py * 4 + px;
+
+          switch(type)
+          {
+            case ResourceFormatType::BC4: scratch[idx] = ToUNorm8(pix.x, false); break;
+            case ResourceFormatType::BC5:
+              scratch[idx] = ToUNorm8(pix.x, false);
+              scratch[16 + idx] = ToUNorm8(pix.y, false);
+              break;
+            case ResourceFormatType::BC6:
+              scratchHalf[idx * 3 + 0] = ConvertToHalf(RDCMAX(pix.x, 0.0f));
+              scratchHalf[idx * 3 + 1] = ConvertToHalf(RDCMAX(pix.y, 0.0f));
+              scratchHalf[idx * 3 + 2] = ConvertToHalf(RDCMAX(pix.z, 0.0f));
+              break;
+            default:
+              scratch[idx * 4 + 0] = ToUNorm8(pix.x, srgb);
+              scratch[idx * 4 + 1] = ToUNorm8(pix.y, srgb);
+              scratch[idx * 4 + 2] = ToUNorm8(pix.z, srgb);
+              // alpha is always linear
+              scratch[idx * 4 + 3] = ToUNorm8(pix.w, false);
+              break;
+          }
+        }
+      }
+
+      switch(type)
+      {
+        case ResourceFormatType::BC1: CompressBlockBC1(scratch, 4 * 4, dst, opts.options); break;
+        case ResourceFormatType::BC2: CompressBlockBC2(scratch, 4 * 4, dst, opts.options); break;
+        case ResourceFormatType::BC3: CompressBlockBC3(scratch, 4 * 4, dst, opts.options); break;
+        case ResourceFormatType::BC4: CompressBlockBC4(scratch, 4, dst, opts.options); break;
+        case ResourceFormatType::BC5:
+          CompressBlockBC5(scratch, 4, scratch + 16, 4, dst, opts.options);
+          break;
+        case ResourceFormatType::BC6:
+          CompressBlockBC6(scratchHalf, 4 * 3, dst, opts.options);
+          break;
+        case ResourceFormatType::BC7: CompressBlockBC7(scratch, 4 * 4, dst, opts.options); break;
+        default: break;
+      }
+
+      dst += blockSize;
+    }
+  });
+
+  return true;
+}
+
+#endif
+
+#if ENABLED(ENABLE_UNIT_TESTS) && DISABLED(RDOC_ANDROID)
+
+#include "catch/catch.hpp"
+
+TEST_CASE("Check block compression round-trips", "[format]")
+{
+  // not a multiple of 4 so the edge blocks are partial
+  const uint32_t width = 70, height = 37;
+
+  rdcarray<FloatVector> pixels;
+  pixels.resize(width * height);
+
+  for(uint32_t y = 0; y < height; y++)
+    for(uint32_t x = 0; x < width; x++)
+      pixels[y * width + x] =
+          FloatVector(float(x) / float(width), float(y) / float(height), 0.5f, 1.0f);
+
+  const uint32_t blocksWide = (width + 3) / 4, blocksHigh = (height + 3) / 4;
+
+  ResourceFormat fmt;
+  fmt.compType = CompType::UNorm;
+
+  SECTION("BC1")
+  {
+    fmt.type = ResourceFormatType::BC1;
+
+    bytebuf out;
+    REQUIRE(BlockCompress(fmt, QualityHint::Fastest, pixels.data(), width, height, out));
+    REQUIRE(out.size() == blocksWide * blocksHigh * 8);
+
+    byte decoded[64];
+
+    // check a block in the middle decodes to roughly the right gradient
+    const uint32_t bx = 8, by = 4;
+    DecompressBlockBC1(out.data() + (by * blocksWide + bx) * 8, decoded, NULL);
+
+    for(uint32_t i = 0; i < 16; i++)
+    {
+      const FloatVector &ref = pixels[(by * 4 + i / 4) * width + bx * 4 + (i % 4)];
+      CHECK(fabsf(decoded[i * 4 + 0] / 255.0f - ref.x) < 0.05f);
+      CHECK(fabsf(decoded[i * 4 + 1] / 255.0f - ref.y) < 0.05f);
+    }
+  };
+
+  SECTION("BC4")
+  {
+    fmt.type = ResourceFormatType::BC4;
+
+    bytebuf out;
+    REQUIRE(BlockCompress(fmt, QualityHint::DontCare, pixels.data(), width, height, out));
+    REQUIRE(out.size() == blocksWide * blocksHigh * 8);
+
+    byte decoded[16];
+
+    // the last block is partial, and should replicate the edge pixel
+    const uint32_t bx = blocksWide - 1, by = blocksHigh - 1;
+    DecompressBlockBC4(out.data() + (by * blocksWide + bx) * 8, decoded, NULL);
+
+    const float edge = pixels[(height - 1) * width + width - 1].x;
+    CHECK(fabsf(decoded[15] / 255.0f - edge) < 0.02f);
+  };
+
+  SECTION("BC7")
+  {
+    fmt.type = ResourceFormatType::BC7;
+
+    bytebuf out;
+    REQUIRE(BlockCompress(fmt, QualityHint::Fastest, pixels.data(), width, height, out));
+    REQUIRE(out.size() == blocksWide * blocksHigh * 16);
+
+    byte decoded[64];
+
+    const uint32_t bx = 3, by = 7;
+    DecompressBlockBC7(out.data() + (by * blocksWide + bx) * 16, decoded, NULL);
+
+    for(uint32_t i = 0; i < 16; i++)
+    {
+      const FloatVector &ref = pixels[(by * 4 + i / 4) * width + bx * 4 + (i % 4)];
+      CHECK(fabsf(decoded[i * 4 + 0] / 255.0f - ref.x) < 0.02f);
+      CHECK(fabsf(decoded[i * 4 + 1] / 255.0f - ref.y) < 0.02f);
+      CHECK(fabsf(decoded[i * 4 + 2] / 255.0f - ref.z) < 0.02f);
+      CHECK(decoded[i * 4 + 3] == 255);
+    }
+  };
+
+  SECTION("Only BC formats are supported")
+  {
+    CHECK(CanBlockCompress(ResourceFormatType::BC6));
+    CHECK_FALSE(CanBlockCompress(ResourceFormatType::Regular));
+    CHECK_FALSE(CanBlockCompress(ResourceFormatType::ETC2));
+  };
+}
+
+#endif    // ENABLED(ENABLE_UNIT_TESTS) && DISABLED(RDOC_ANDROID)
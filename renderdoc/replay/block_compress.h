@@ -0,0 +1,49 @@
+/******************************************************************************
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019-2024 Baldur Karlsson
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ ******************************************************************************/
+
+#pragma once
+
+#include "api/replay/renderdoc_replay.h"
+
+// CPU encoding to the BC1-BC7 block compressed formats. Rows of blocks are spread across worker
+// threads, each block is gathered into a fixed scratch buffer and encoded with compressonator.
+
+// returns true if BlockCompress() can encode to this format type. Always false on platforms where
+// the encoder isn't built.
+bool CanBlockCompress(ResourceFormatType type);
+
+// the size in bytes of one 4x4 block of the given BC format
+uint32_t GetBlockCompressedSize(ResourceFormatType type);
+
+// compress a tightly packed width x height image of float RGBA pixels into tightly packed rows of
+// blocks in the type of fmt. Partial blocks at the right and bottom edges replicate the last
+// column/row.
+//
+// BC1-BC5 and BC7 encode [0, 1], and if fmt is UNormSRGB the pixels are converted from linear to
+// sRGB first. BC4 and BC5 use the first one and two channels. BC6 encodes unsigned half floats.
+//
+// quality selects how exhaustive the encoder's search is, mostly relevant for BC6 and BC7 which
+// are orders of magnitude slower at Nicest than at Fastest.
+bool BlockCompress(const ResourceFormat &fmt, QualityHint quality, const FloatVector *pixels,
+                   uint32_t width, uint32_t height, bytebuf &out);
@@ -116,6 +116,8 @@ public:
   double TimestampFrequency() { return m_RDC ? m_RDC->GetTimestampFrequency() : 1.0; }
   rdcpair<ResultDetails, IReplayController *> OpenCapture(const ReplayOptions &opts,
                                                           RENDERDOC_ProgressCallback progress);
+  ResultDetails RunReplayJobs(const ReplayOptions &opts, uint32_t numReplays, uint32_t numJobs,
+                              RENDERDOC_ReplayJobCallback job, RENDERDOC_ProgressCallback progress);
 
   void SetMetadata(const rdcstr &driverName, uint64_t machineIdent, FileType thumbType,
                    uint32_t thumbWidth, uint32_t thumbHeight, const bytebuf &thumbData,
@@ -195,6 +197,8 @@ CaptureFile::~CaptureFile()
 ResultDetails CaptureFile::OpenFile(const rdcstr &filename, const rdcstr &filetype,
                                     RENDERDOC_ProgressCallback progress)
 {
+  RENDERDOC_PROFILEFUNCTION();
+
   CaptureImporter importer = RenderDoc::Inst().GetCaptureImporter(filetype);
 
   if(importer)
@@ -320,6 +324,8 @@ ResultDetails CaptureFile::Init()
 
 RDResult CaptureFile::InitStructuredData(RENDERDOC_ProgressCallback progress)
 {
+  RENDERDOC_PROFILEFUNCTION();
+
   if(m_StructuredData.chunks.empty())
   {
     if(m_RDC && m_RDC->SectionIndex(SectionType::FrameCapture) >= 0)
@@ -351,6 +357,8 @@ RDResult CaptureFile::InitStructuredData(RENDERDOC_ProgressCallback progress)
 rdcpair<ResultDetails, IReplayController *> CaptureFile::OpenCapture(const ReplayOptions &opts,
                                                                      RENDERDOC_ProgressCallback progress)
 {
+  RENDERDOC_PROFILEFUNCTION();
+
   ResultDetails ret;
   ReplayController *render = NULL;
 
@@ -381,6 +389,104 @@ rdcpair<ResultDetails, IReplayController *> CaptureFile::OpenCapture(const Repla
   return {ret, render};
 }
 
+ResultDetails CaptureFile::RunReplayJobs(const ReplayOptions &opts, uint32_t numReplays,
+                                         uint32_t numJobs, RENDERDOC_ReplayJobCallback job,
+                                         RENDERDOC_ProgressCallback progress)
+{
+  RENDERDOC_PROFILEFUNCTION();
+
+  if(!m_RDC)
+    return RDResult(ResultCode::InternalError, "RDC file unexpectedly NULL");
+
+  RDResult ret = m_RDC->Error();
+
+  if(ret != ResultCode::Succeeded)
+    return ret;
+
+  if(numJobs == 0 || !job)
+    return ResultDetails({ResultCode::Succeeded});
+
+  numReplays = RDCCLAMP(numReplays, 1U, numJobs);
+
+  LogReplayOptions(opts);
+
+  // opening and closing replays reads from the capture and may touch global state, so only one
+  // replay does that at a time. The jobs themselves run fully in parallel.
+  Threading::CriticalSection lock;
+  int32_t nextJob = 0;
+  int32_t jobsDone = 0;
+
+  rdcarray<Threading::ThreadHandle> threads;
+  threads.reserve(numReplays);
+
+  for(uint32_t i = 0; i < numReplays; i++)
+  {
+    threads.push_back(Threading::CreateThread([&]() {
+      ReplayController *render = NULL;
+
+      {
+        SCOPED_LOCK(lock);
+
+        // don't bother opening a replay if the others have already taken every job
+        if(Atomic::CmpExch32(&nextJob, 0, 0) >= (int32_t)numJobs)
+          return;
+
+        render = new ReplayController();
+
+        RDResult res = render->CreateDevice(m_RDC, opts);
+
+        if(res != ResultCode::Succeeded)
+        {
+          RDCERR("Couldn't open replay for jobs: %s", res.Message().c_str());
+
+          if(ret == ResultCode::Succeeded)
+            ret = res;
+
+          render->Shutdown();
+          return;
+        }
+      }
+
+      for(;;)
+      {
+        int32_t idx = Atomic::Inc32(&nextJob) - 1;
+        if(idx >= (int32_t)numJobs)
+          break;
+
+        job(render, (uint32_t)idx);
+
+        int32_t done = Atomic::Inc32(&jobsDone);
+
+        if(progress)
+        {
+          SCOPED_LOCK(lock);
+          progress(float(done) / float(numJobs));
+        }
+      }
+
+      {
+        SCOPED_LOCK(lock);
+        render->Shutdown();
+      }
+    }));
+  }
+
+  for(Threading::ThreadHandle t : threads)
+  {
+    Threading::JoinThread(t);
+    Threading::CloseThread(t);
+  }
+
+  // as long as any replay opened successfully, every job will have been run
+  if(jobsDone == (int32_t)numJobs)
+    return ResultDetails({ResultCode::Succeeded});
+
+  if(ret == ResultCode::Succeeded)
+    ret = RDResult(ResultCode::InternalError, "Not all replay jobs completed");
+
+  return ret;
+}
+
 void CaptureFile::SetMetadata(const rdcstr &driverName, uint64_t machineIdent, FileType thumbType,
                               uint32_t thumbWidth, uint32_t thumbHeight, const bytebuf &thumbData,
                               uint64_t timeBase, double timeFreq)
@@ -415,6 +521,8 @@ void CaptureFile::SetMetadata(const rdcstr &driverName, uint64_t machineIdent, F
 ResultDetails CaptureFile::Convert(const rdcstr &filename, const rdcstr &filetype,
                                    const SDFile *file, RENDERDOC_ProgressCallback progress)
 {
+  RENDERDOC_PROFILEFUNCTION();
+
   if(!m_RDC)
   {
     RETURN_ERROR_RESULT(ResultCode::FileCorrupted,
@@ -23,6 +23,7 @@
  * THE SOFTWARE.
  ******************************************************************************/
 
+#include <float.h>
 #include "android/android.h"
 #include "api/replay/renderdoc_replay.h"
 #include "api/replay/version.h"
@@ -30,6 +31,7 @@
 #include "common/formatting.h"
 #include "common/threading.h"
 #include "core/core.h"
+#include "core/tracing.h"
 #include "maths/camera.h"
 #include "maths/formatpacking.h"
 #include "miniz/miniz.h"
@@ -180,6 +182,172 @@ extern "C" RENDERDOC_API uint32_t RENDERDOC_CC RENDERDOC_VertexOffset(Topology t
   return primitive * RENDERDOC_NumVerticesPerPrimitive(topology);
 }
 
+extern "C" RENDERDOC_API rdcpair<FloatVector, FloatVector> RENDERDOC_CC
+RENDERDOC_CalculateVertexBounds(const ResourceFormat &format, const bytebuf &data, uint64_t offset,
+                                uint32_t stride, uint32_t numVerts, const bytebuf &indices,
+                                uint32_t indexByteWidth, int32_t baseVertex, uint32_t primRestart)
+{
+  uint32_t compCount = RDCMIN(4U, (uint32_t)format.compCount);
+  if(format.type == ResourceFormatType::R10G10B10A2)
+    compCount = 4;
+  else if(format.type == ResourceFormatType::R11G11B10)
+    compCount = 3;
+
+  rdcpair<FloatVector, FloatVector> ret;
+
+  float *mn = &ret.first.x;
+  float *mx = &ret.second.x;
+  for(uint32_t c = 0; c < 4; c++)
+  {
+    mn[c] = c < compCount ? FLT_MAX : 0.0f;
+    mx[c] = c < compCount ? -FLT_MAX : 0.0f;
+  }
+
+  const uint64_t elemSize = RDCMAX(1U, format.ElementSize());
+
+  if(numVerts == 0 || offset + elemSize > data.size())
+    return ret;
+
+  // the number of vertices that can be read without going out of bounds
+  uint64_t availVerts = stride == 0 ? 1 : (data.size() - offset - elemSize) / stride + 1;
+
+  const byte *base = data.data() + offset;
+
+  // check that we can decode this format at all before doing any work
+  {
+    bool success = true;
+    DecodeFormattedComponents(format, base, &success);
+    if(!success)
+    {
+      RDCWARN("Can't calculate vertex bounds for format %s", format.Name().c_str());
+      return ret;
+    }
+  }
+
+  // with indices, flag each referenced vertex in a bitmask. Walking the set bits in order gives a
+  // sorted and unique iteration which is friendlier to the cache and decodes each vertex once.
+  const bool indexed = !indices.empty() && stride != 0 &&
+                       (indexByteWidth == 1 || indexByteWidth == 2 || indexByteWidth == 4);
+
+  rdcarray<uint32_t> used;
+
+  if(indexed)
+  {
+    used.resize(size_t((availVerts + 31) / 32));
+
+    const uint32_t numIndices = RDCMIN(numVerts, uint32_t(indices.size() / indexByteWidth));
+
+    for(uint32_t i = 0; i < numIndices; i++)
+    {
+      uint32_t idx = 0;
+      if(indexByteWidth == 1)
+        idx = indices[i];
+      else if(indexByteWidth == 2)
+        idx = ((const uint16_t *)indices.data())[i];
+      else
+        idx = ((const uint32_t *)indices.data())[i];
+
+      // check for primitive restart *before* adding base vertex
+      if(primRestart && idx == primRestart)
+        continue;
+
+      // apply base vertex but clamp to 0 if subtracting
+      if(baseVertex < 0)
+        idx = idx < uint32_t(-baseVertex) ? 0 : idx - uint32_t(-baseVertex);
+      else
+        idx += uint32_t(baseVertex);
+
+      if(idx < availVerts)
+        used[idx / 32] |= 1U << (idx % 32);
+    }
+  }
+  else
+  {
+    availVerts = RDCMIN(availVerts, (uint64_t)numVerts);
+  }
+
+  // split into chunks of vertices which are decoded and reduced independently
+  const uint64_t chunkSize = 32 * 512;
+  const uint32_t numChunks = uint32_t((availVerts + chunkSize - 1) / chunkSize);
+
+  rdcarray<rdcpair<FloatVector, FloatVector>> chunkBounds;
+  chunkBounds.resize(numChunks);
+
+  Threading::ParallelFor(numChunks, [&](uint32_t chunk) {
+    FloatVector chunkMin = ret.first, chunkMax = ret.second;
+
+    FloatVector decoded[256];
+
+    // decode and reduce a contiguous run of vertices
+    auto processRun = [&](uint64_t first, uint64_t count) {
+      while(count > 0)
+      {
+        const size_t num = (size_t)RDCMIN(count, (uint64_t)ARRAY_COUNT(decoded));
+        DecodeFormattedComponentsRow(format, base + first * stride, stride, num, decoded);
+        AccumulateFiniteMinMax(decoded, num, chunkMin, chunkMax);
+        first += num;
+        count -= num;
+      }
+    };
+
+    const uint64_t begin = chunk * chunkSize;
+    const uint64_t end = RDCMIN(begin + chunkSize, availVerts);
+
+    if(indexed)
+    {
+      uint64_t runStart = 0, runLength = 0;
+
+      for(uint64_t v = begin; v < end; v += 32)
+      {
+        uint32_t bits = used[size_t(v / 32)];
+
+        // extend the current run quickly over fully used words
+        if(bits == ~0U && runLength > 0 && runStart + runLength == v)
+        {
+          runLength += 32;
+          continue;
+        }
+
+        while(bits)
+        {
+          uint64_t idx = v + Bits::CountTrailingZeroes(bits);
+          bits &= bits - 1;
+
+          if(runLength > 0 && runStart + runLength == idx)
+          {
+            runLength++;
+          }
+          else
+          {
+            processRun(runStart, runLength);
+            runStart = idx;
+            runLength = 1;
+          }
+        }
+      }
+
+      processRun(runStart, runLength);
+    }
+    else
+    {
+      processRun(begin, end - begin);
+    }
+
+    chunkBounds[chunk] = {chunkMin, chunkMax};
+  });
+
+  for(const rdcpair<FloatVector, FloatVector> &b : chunkBounds)
+  {
+    for(uint32_t c = 0; c < compCount; c++)
+    {
+      mn[c] = RDCMIN(mn[c], (&b.first.x)[c]);
+      mx[c] = RDCMAX(mx[c], (&b.second.x)[c]);
+    }
+  }
+
+  return ret;
+}
+
 extern "C" RENDERDOC_API float RENDERDOC_CC RENDERDOC_HalfToFloat(uint16_t half)
 {
   return ConvertFromHalf(half);
@@ -1008,11 +1176,172 @@ extern "C" RENDERDOC_API int RENDERDOC_CC RENDERDOC_RunFunctionalTests(int pytho
 }
 
 extern "C" RENDERDOC_API void RENDERDOC_CC RENDERDOC_BeginProfileRegion(const rdcstr &name)
+{
+  Superluminal::BeginProfileRange(name.c_str());
+  Tracing::BeginRegion(name);
+}
+
+extern "C" RENDERDOC_API void RENDERDOC_CC RENDERDOC_BeginStaticProfileRegion(const char *name)
 {
   Superluminal::BeginProfileRange(name);
+  Tracing::BeginRegion(name);
 }
 
 extern "C" RENDERDOC_API void RENDERDOC_CC RENDERDOC_EndProfileRegion()
 {
   Superluminal::EndProfileRange();
+  Tracing::EndRegion();
 }
+
+#if ENABLED(ENABLE_UNIT_TESTS)
+
+#include "catch/catch.hpp"
+
+TEST_CASE("Check vertex bounds calculation", "[format]")
+{
+  // interleaved vertices: float3 position at offset 4, followed by a ubyte2 unorm attribute
+  const uint32_t stride = 20;
+  const uint32_t numVerts = 50000;
+
+  bytebuf data;
+  data.resize(numVerts * stride);
+
+  for(uint32_t v = 0; v < numVerts; v++)
+  {
+    float pos[3] = {
+        float(v % 1000) - 200.0f,
+        float((v * 7919) % 4001) * 0.5f,
+        -float(v) * 0.01f,
+    };
+    memcpy(data.data() + v * stride + 4, pos, sizeof(pos));
+    data[v * stride + 16] = byte(v * 13);
+    data[v * stride + 17] = byte(v % 200);
+  }
+
+  ResourceFormat posFmt;
+  posFmt.type = ResourceFormatType::Regular;
+  posFmt.compType = CompType::Float;
+  posFmt.compByteWidth = 4;
+  posFmt.compCount = 3;
+
+  ResourceFormat texFmt;
+  texFmt.type = ResourceFormatType::Regular;
+  texFmt.compType = CompType::UNorm;
+  texFmt.compByteWidth = 1;
+  texFmt.compCount = 2;
+
+  // reference implementation, decoding each vertex separately
+  auto reference = [&](const ResourceFormat &fmt, uint32_t offset,
+                       const rdcarray<uint32_t> &verts) {
+    FloatVector mn(FLT_MAX, FLT_MAX, FLT_MAX, FLT_MAX), mx(-FLT_MAX, -FLT_MAX, -FLT_MAX, -FLT_MAX);
+    for(uint32_t v : verts)
+    {
+      if(v >= numVerts)
+        continue;
+      FloatVector f = DecodeFormattedComponents(fmt, data.data() + offset + v * stride);
+      for(uint32_t c = 0; c < 4; c++)
+      {
+        if(c >= fmt.compCount)
+        {
+          (&mn.x)[c] = (&mx.x)[c] = 0.0f;
+        }
+        else if(RDCISFINITE((&f.x)[c]))
+        {
+          (&mn.x)[c] = RDCMIN((&mn.x)[c], (&f.x)[c]);
+          (&mx.x)[c] = RDCMAX((&mx.x)[c], (&f.x)[c]);
+        }
+      }
+    }
+    return make_rdcpair(mn, mx);
+  };
+
+  rdcarray<uint32_t> allVerts;
+  for(uint32_t v = 0; v < numVerts; v++)
+    allVerts.push_back(v);
+
+  SECTION("Unindexed")
+  {
+    // poison a couple of positions with non-finite values, these should be ignored
+    float inf = std::numeric_limits<float>::infinity();
+    float nan = std::numeric_limits<float>::quiet_NaN();
+    memcpy(data.data() + 123 * stride + 4, &inf, sizeof(float));
+    memcpy(data.data() + 4567 * stride + 12, &nan, sizeof(float));
+
+    rdcpair<FloatVector, FloatVector> bounds =
+        RENDERDOC_CalculateVertexBounds(posFmt, data, 4, stride, numVerts, {}, 0, 0, 0);
+    rdcpair<FloatVector, FloatVector> ref = reference(posFmt, 4, allVerts);
+
+    CHECK(bounds.first == ref.first);
+    CHECK(bounds.second == ref.second);
+    CHECK(bounds.first.x == -200.0f);
+    CHECK(bounds.second.x == 799.0f);
+    CHECK(bounds.first.w == 0.0f);
+    CHECK(bounds.second.w == 0.0f);
+
+    bounds = RENDERDOC_CalculateVertexBounds(texFmt, data, 16, stride, numVerts, {}, 0, 0, 0);
+    ref = reference(texFmt, 16, allVerts);
+
+    CHECK(bounds.first == ref.first);
+    CHECK(bounds.second == ref.second);
+    CHECK(bounds.second.x == 1.0f);
+    CHECK(bounds.first.z == 0.0f);
+
+    // asking for more vertices than are present only processes the available ones
+    bounds = RENDERDOC_CalculateVertexBounds(posFmt, data, 4, stride, numVerts * 2, {}, 0, 0, 0);
+    ref = reference(posFmt, 4, allVerts);
+
+    CHECK(bounds.first == ref.first);
+    CHECK(bounds.second == ref.second);
+  };
+
+  SECTION("Indexed")
+  {
+    const uint32_t restart = 0xffff;
+    const int32_t baseVertex = -10;
+
+    rdcarray<uint16_t> idx16;
+    rdcarray<uint32_t> resolved;
+
+    for(uint32_t i = 0; i < 30000; i++)
+    {
+      uint16_t idx = uint16_t((i * 7) % 40000);
+      if(i % 100 == 99)
+        idx = uint16_t(restart);
+
+      idx16.push_back(idx);
+
+      if(idx != restart)
+        resolved.push_back(idx < 10 ? 0 : idx - 10);
+    }
+
+    bytebuf indices((const byte *)idx16.data(), idx16.byteSize());
+
+    rdcpair<FloatVector, FloatVector> bounds = RENDERDOC_CalculateVertexBounds(
+        posFmt, data, 4, stride, idx16.count(), indices, 2, baseVertex, restart);
+    rdcpair<FloatVector, FloatVector> ref = reference(posFmt, 4, resolved);
+
+    CHECK(bounds.first == ref.first);
+    CHECK(bounds.second == ref.second);
+
+    // only use the first few indices
+    bounds = RENDERDOC_CalculateVertexBounds(posFmt, data, 4, stride, 3, indices, 2, baseVertex,
+                                             restart);
+    resolved.resize(3);
+    ref = reference(posFmt, 4, resolved);
+
+    CHECK(bounds.first == ref.first);
+    CHECK(bounds.second == ref.second);
+
+    // out of bounds indices are skipped
+    rdcarray<uint32_t> idx32 = {5, numVerts + 100, 7};
+    indices = bytebuf((const byte *)idx32.data(), idx32.byteSize());
+
+    bounds = RENDERDOC_CalculateVertexBounds(texFmt, data, 16, stride, 3, indices, 4, 0, 0);
+    ref = reference(texFmt, 16, idx32);
+
+    CHECK(bounds.first == ref.first);
+    CHECK(bounds.second == ref.second);
+  };
+}
+
+#endif    // ENABLED(ENABLE_UNIT_TESTS)
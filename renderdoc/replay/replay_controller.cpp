@@ -32,6 +32,8 @@
 #include "jpeg-compressor/jpgd.h"
 #include "jpeg-compressor/jpge.h"
 #include "maths/formatpacking.h"
+#include "miniz/miniz.h"
+#include "replay/block_compress.h"
 #include "os/os_specific.h"
 #include "serialise/rdcfile.h"
 #include "serialise/serialiser.h"
@@ -45,6 +47,132 @@ static void fileWriteFunc(void *context, void *data, int size)
   FileIO::fwrite(data, 1, size, (FILE *)context);
 }
 
+// input bytes per independently compressed deflate strip. Each strip loses the dictionary of the
+// previous one, but at this size the difference in output size is negligible.
+static const size_t DeflateStripSize = 256 * 1024;
+
+// zlib's adler32_combine - the checksum of A+B from the checksums of A and B and the length of B
+static uint32_t CombineAdler32(uint32_t adlerA, uint32_t adlerB, size_t lenB)
+{
+  const uint32_t base = 65521;
+
+  uint32_t rem = uint32_t(lenB % base);
+  uint32_t sum1 = adlerA & 0xffff;
+  uint32_t sum2 = (rem * sum1) % base;
+  sum1 += (adlerB & 0xffff) + base - 1;
+  sum2 += ((adlerA >> 16) & 0xffff) + ((adlerB >> 16) & 0xffff) + base - rem;
+  if(sum1 >= base)
+    sum1 -= base;
+  if(sum1 >= base)
+    sum1 -= base;
+  if(sum2 >= (base << 1))
+    sum2 -= (base << 1);
+  if(sum2 >= base)
+    sum2 -= base;
+  return sum1 | (sum2 << 16);
+}
+
+static mz_bool deflateWriteFunc(const void *data, int len, void *user)
+{
+  bytebuf *out = (bytebuf *)user;
+  out->append((const byte *)data, len);
+  return MZ_TRUE;
+}
+
+// stb_image_write's zlib compressor, used for PNG, is single threaded and not particularly fast.
+// This replaces it (via STBIW_ZLIB_COMPRESS in stb_impl.c) with miniz compressing independent
+// strips in parallel. Every strip but the last ends with a sync flush so the raw deflate streams
+// can be concatenated into one valid stream.
+extern "C" unsigned char *rdoc_stbiw_zlib_compress(unsigned char *data, int data_len, int *out_len,
+                                                   int quality)
+{
+  const size_t len = (size_t)RDCMAX(data_len, 0);
+  const uint32_t numStrips = RDCMAX(1U, uint32_t((len + DeflateStripSize - 1) / DeflateStripSize));
+
+  const mz_uint flags =
+      tdefl_create_comp_flags_from_zip_params(RDCCLAMP(quality, 0, 10), -MZ_DEFAULT_WINDOW_BITS,
+                                              MZ_DEFAULT_STRATEGY) |
+      TDEFL_COMPUTE_ADLER32;
+
+  rdcarray<bytebuf> strips;
+  rdcarray<uint32_t> adlers;
+  strips.resize(numStrips);
+  adlers.resize(numStrips);
+
+  int32_t failed = 0;
+
+  Threading::ParallelFor(numStrips, [&](uint32_t i) {
+    const size_t offs = i * DeflateStripSize;
+    const size_t size = RDCMIN(len - offs, DeflateStripSize);
+
+    tdefl_compressor *comp = tdefl_compressor_alloc();
+
+    strips[i].reserve(size / 2);
+
+    if(!comp || tdefl_init(comp, &deflateWriteFunc, &strips[i], flags) != TDEFL_STATUS_OKAY ||
+       tdefl_compress_buffer(comp, data + offs, size,
+                             i + 1 == numStrips ? TDEFL_FINISH : TDEFL_SYNC_FLUSH) !=
+           (i + 1 == numStrips ? TDEFL_STATUS_DONE : TDEFL_STATUS_OKAY))
+      Atomic::Inc32(&failed);
+    else
+      adlers[i] = tdefl_get_adler32(comp);
+
+    tdefl_compressor_free(comp);
+  });
+
+  if(failed)
+    return NULL;
+
+  uint32_t adler = 1;
+  size_t total = 2 + 4;
+  for(uint32_t i = 0; i < numStrips; i++)
+  {
+    const size_t offs = i * DeflateStripSize;
+    adler = CombineAdler32(adler, adlers[i], RDCMIN(len - offs, DeflateStripSize));
+    total += strips[i].size();
+  }
+
+  // must be allocated with malloc since stb frees it
+  unsigned char *ret = (unsigned char *)malloc(total);
+  if(!ret)
+    return NULL;
+
+  unsigned char *dst = ret;
+
+  // zlib header, deflate with a 32k window, same as stb
+  *(dst++) = 0x78;
+  *(dst++) = 0x5e;
+
+  for(const bytebuf &strip : strips)
+  {
+    memcpy(dst, strip.data(), strip.size());
+    dst += strip.size();
+  }
+
+  *(dst++) = byte((adler >> 24) & 0xff);
+  *(dst++) = byte((adler >> 16) & 0xff);
+  *(dst++) = byte((adler >> 8) & 0xff);
+  *(dst++) = byte((adler >> 0) & 0xff);
+
+  *out_len = (int)total;
+
+  return ret;
+}
+
+// rows per strip when converting images on save. Large enough that the per-strip overhead is
+// negligible, small enough that typical render target sizes still spread across all cores.
+static const uint32_t SaveStripRows = 64;
+
+static void ForEachRowStrip(uint32_t height, std::function<void(uint32_t, uint32_t)> func)
+{
+  const uint32_t numStrips = (height + SaveStripRows - 1) / SaveStripRows;
+
+  Threading::ParallelFor(numStrips, [&](uint32_t strip) {
+    const uint32_t y0 = strip * SaveStripRows;
+    func(y0, RDCMIN(height, y0 + SaveStripRows));
+  });
+}
+
 ReplayController::ReplayController()
 {
   m_ThreadID = Threading::GetCurrentID();
@@ -84,10 +212,57 @@ void ReplayController::SetFrameEvent(uint32_t eventId, bool force)
     m_pDevice->ReplayLog(eventId, eReplay_OnlyDraw);
     FatalErrorCheck();
 
+    // anything prefetched may be stale if we're being forced to refresh
+    if(force)
+      m_PrefetchedEvents.clear();
+
     FetchPipelineState(eventId);
   }
 }
 
+void ReplayController::PrefetchFrameEvent(uint32_t eventId)
+{
+  CHECK_REPLAY_THREAD();
+
+  RENDERDOC_PROFILEFUNCTION();
+
+  auto it = m_EventRemap.find(eventId);
+  if(it != m_EventRemap.end())
+    eventId = it->second;
+
+  if(eventId == m_EventID)
+    return;
+
+  for(const PrefetchedEvent &prefetch : m_PrefetchedEvents)
+    if(prefetch.eventId == eventId)
+      return;
+
+  // we only expect to prefetch the next event or two, so keep the most recent few
+  const size_t maxPrefetchedEvents = 4;
+  if(m_PrefetchedEvents.size() >= maxPrefetchedEvents)
+    m_PrefetchedEvents.erase(0);
+
+  m_PrefetchedEvents.push_back(PrefetchedEvent());
+  PrefetchedEvent &prefetch = m_PrefetchedEvents.back();
+  prefetch.eventId = eventId;
+
+  // point the device at the prefetch storage so the current state is untouched while we're away
+  m_pDevice->SetPipelineStates(&prefetch.d3d11, &prefetch.d3d12, &prefetch.gl, &prefetch.vk);
+
+  m_pDevice->ReplayLog(eventId, eReplay_Full);
+  m_pDevice->SavePipelineState(eventId);
+  FetchDescriptors(eventId, prefetch.access, prefetch.descriptors, prefetch.samplerDescriptors);
+
+  m_pDevice->SetPipelineStates(&m_D3D11PipelineState, &m_D3D12PipelineState, &m_GLPipelineState,
+                               &m_VulkanPipelineState);
+
+  // restore back to where we were
+  m_pDevice->ReplayLog(m_EventID, eReplay_Full);
+
+  if(FatalErrorCheck())
+    m_PrefetchedEvents.pop_back();
+}
+
 const D3D11Pipe::State *ReplayController::GetD3D11PipelineState()
 {
   CHECK_REPLAY_THREAD();
@@ -764,6 +939,8 @@ ResultDetails ReplayController::SaveTexture(const TextureSave &saveData, const r
   }
 
   rdcarray<byte *> subdata;
+  // the dimensions of each entry in subdata, for block compressing
+  rdcarray<rdcpair<uint32_t, uint32_t>> subdims;
 
   bool downcast = false;
 
@@ -795,6 +972,27 @@ ResultDetails ReplayController::SaveTexture(const TextureSave &saveData, const r
      td.format.type != ResourceFormatType::R11G11B10)
     downcast = true;
 
+  // block compress on the CPU when writing uncompressed data to DDS. The data is fetched as RGBA32
+  // and encoded just before writing.
+  ResourceFormat compressFmt;
+  bool blockCompress = sd.destType == FileType::DDS && CanBlockCompress(sd.blockCompression) &&
+                       !td.format.BlockFormat();
+
+  if(blockCompress)
+  {
+    compressFmt.type = sd.blockCompression;
+    compressFmt.compCount = 4;
+    compressFmt.compByteWidth = 1;
+    compressFmt.compType = CompType::UNorm;
+
+    if(td.format.SRGBCorrected() &&
+       (compressFmt.type == ResourceFormatType::BC1 || compressFmt.type == ResourceFormatType::BC2 ||
+        compressFmt.type == ResourceFormatType::BC3 || compressFmt.type == ResourceFormatType::BC7))
+      compressFmt.compType = CompType::UNormSRGB;
+
+    downcast = true;
+  }
+
   // if we're downcasting, pick either RGBA8 or RGBA32 to downcast to
   RemapTexture remap = RemapTexture::NoRemap;
 
@@ -813,8 +1011,8 @@ ResultDetails ReplayController::SaveTexture(const TextureSave &saveData, const r
         td.format.type == ResourceFormatType::YUV12 || td.format.type == ResourceFormatType::YUV16;
 
     // if the source and destination have more than 1 byte per component, remap to RGBA32 to avoid
-    // precision loss
-    if(sourceHDR && destHDR)
+    // precision loss. Block compression always works from RGBA32
+    if((sourceHDR && destHDR) || blockCompress)
     {
       remap = RemapTexture::RGBA32;
       td.format.compByteWidth = 4;
@@ -921,20 +1119,21 @@ ResultDetails ReplayController::SaveTexture(const TextureSave &saveData, const r
                             sub.slice, sub.sample);
       }
 
+      uint32_t w = RDCMAX(1U, td.width >> m);
+      uint32_t h = RDCMAX(1U, td.height >> m);
+      uint32_t d = RDCMAX(1U, td.depth >> m);
+
       if(td.depth == 1)
       {
         byte *bytes = new byte[data.size()];
         memcpy(bytes, data.data(), data.size());
         subdata.push_back(bytes);
+        subdims.push_back({w, h});
         continue;
       }
 
       uint32_t mipSlicePitch = slicePitch;
 
-      uint32_t w = RDCMAX(1U, td.width >> m);
-      uint32_t h = RDCMAX(1U, td.height >> m);
-      uint32_t d = RDCMAX(1U, td.depth >> m);
-
       if(blockformat)
       {
         mipSlicePitch = RDCMAX(1U, ((w + 3) / 4)) * blockSize * RDCMAX(1U, h / 4);
@@ -954,6 +1153,7 @@ ResultDetails ReplayController::SaveTexture(const TextureSave &saveData, const r
         byte *b = data.data() + mipSlicePitch * sliceOffset;
         memcpy(depthslice, b, mipSlicePitch);
         subdata.push_back(depthslice);
+        subdims.push_back({w, h});
 
         continue;
       }
@@ -970,6 +1170,7 @@ ResultDetails ReplayController::SaveTexture(const TextureSave &saveData, const r
         memcpy(depthslice, b, mipSlicePitch);
 
         subdata.push_back(depthslice);
+        subdims.push_back({w, h});
 
         b += mipSlicePitch;
       }
@@ -996,28 +1197,20 @@ ResultDetails ReplayController::SaveTexture(const TextureSave &saveData, const r
 
     memset(combinedData, 0, td.width * td.height * pixelStride);
 
-    for(size_t i = 0; i < subdata.size(); i++)
-    {
-      uint32_t gridx = (uint32_t)i % sd.slice.sliceGridWidth;
-      uint32_t gridy = (uint32_t)i / sd.slice.sliceGridWidth;
+    Threading::ParallelFor((uint32_t)subdata.size(), [&](uint32_t i) {
+      uint32_t gridx = i % sd.slice.sliceGridWidth;
+      uint32_t gridy = i / sd.slice.sliceGridWidth;
 
       uint32_t yoffs = gridy * sliceHeight;
       uint32_t xoffs = gridx * sliceWidth;
 
       for(uint32_t y = 0; y < sliceHeight; y++)
-      {
-        for(uint32_t x = 0; x < sliceWidth; x++)
-        {
-          uint32_t *srcpix = (uint32_t *)&subdata[i][(y * sliceWidth + x) * pixelStride + 0];
-          uint32_t *dstpix =
-              (uint32_t *)&combinedData[((y + yoffs) * td.width + x + xoffs) * pixelStride + 0];
-
-          memcpy(dstpix, srcpix, pixelStride);
-        }
-      }
+        memcpy(&combinedData[((y + yoffs) * td.width + xoffs) * pixelStride],
+               &subdata[i][y * sliceWidth * pixelStride], sliceWidth * pixelStride);
+    });
 
+    for(size_t i = 0; i < subdata.size(); i++)
       delete[] subdata[i];
-    }
 
     subdata.resize(1);
     subdata[0] = combinedData;
@@ -1058,25 +1251,17 @@ ResultDetails ReplayController::SaveTexture(const TextureSave &saveData, const r
     uint32_t gridx[6] = {2, 0, 1, 1, 1, 3};
     uint32_t gridy[6] = {1, 1, 0, 2, 1, 1};
 
-    for(size_t i = 0; i < subdata.size(); i++)
-    {
+    Threading::ParallelFor((uint32_t)subdata.size(), [&](uint32_t i) {
       uint32_t yoffs = gridy[i] * sliceHeight;
       uint32_t xoffs = gridx[i] * sliceWidth;
 
       for(uint32_t y = 0; y < sliceHeight; y++)
-      {
-        for(uint32_t x = 0; x < sliceWidth; x++)
-        {
-          uint32_t *srcpix = (uint32_t *)&subdata[i][(y * sliceWidth + x) * pixelStride + 0];
-          uint32_t *dstpix =
-              (uint32_t *)&combinedData[((y + yoffs) * td.width + x + xoffs) * pixelStride + 0];
-
-          memcpy(dstpix, srcpix, pixelStride);
-        }
-      }
+        memcpy(&combinedData[((y + yoffs) * td.width + xoffs) * pixelStride],
+               &subdata[i][y * sliceWidth * pixelStride], sliceWidth * pixelStride);
+    });
 
+    for(size_t i = 0; i < subdata.size(); i++)
       delete[] subdata[i];
-    }
 
     subdata.resize(1);
     subdata[0] = combinedData;
@@ -1095,37 +1280,41 @@ ResultDetails ReplayController::SaveTexture(const TextureSave &saveData, const r
     uint32_t compWidth = td.format.compByteWidth;
     uint32_t compCount = td.format.compCount;
 
-    uint32_t val = 0;
-    uint32_t max = ~0U;
+    const uint32_t max = ~0U;
 
-    for(uint32_t y = 0; y < td.height; y++)
-    {
-      for(uint32_t x = 0; x < td.width; x++)
-      {
-        memcpy(&val, &subdata[0][(y * td.width + x) * pixelStride + sd.channelExtract * compWidth],
-               td.format.compByteWidth);
+    ForEachRowStrip(td.height, [&](uint32_t y0, uint32_t y1) {
+      uint32_t val = 0;
 
-        switch(compCount)
+      for(uint32_t y = y0; y < y1; y++)
+      {
+        for(uint32_t x = 0; x < td.width; x++)
         {
-          case 4:
-            memcpy(&subdata[0][(y * td.width + x) * pixelStride + 3 * compWidth], &max,
-                   td.format.compByteWidth);
-            DELIBERATE_FALLTHROUGH();
-          case 3:
-            memcpy(&subdata[0][(y * td.width + x) * pixelStride + 2 * compWidth], &val,
-                   td.format.compByteWidth);
-            DELIBERATE_FALLTHROUGH();
-          case 2:
-            memcpy(&subdata[0][(y * td.width + x) * pixelStride + 1 * compWidth], &val,
-                   td.format.compByteWidth);
-            DELIBERATE_FALLTHROUGH();
-          case 1:
-            memcpy(&subdata[0][(y * td.width + x) * pixelStride + 0 * compWidth], &val,
-                   td.format.compByteWidth);
-            break;
+          memcpy(&val,
+                 &subdata[0][(y * td.width + x) * pixelStride + sd.channelExtract * compWidth],
+                 td.format.compByteWidth);
+
+          switch(compCount)
+          {
+            case 4:
+              memcpy(&subdata[0][(y * td.width + x) * pixelStride + 3 * compWidth], &max,
+                     td.format.compByteWidth);
+              DELIBERATE_FALLTHROUGH();
+            case 3:
+              memcpy(&subdata[0][(y * td.width + x) * pixelStride + 2 * compWidth], &val,
+                     td.format.compByteWidth);
+              DELIBERATE_FALLTHROUGH();
+            case 2:
+              memcpy(&subdata[0][(y * td.width + x) * pixelStride + 1 * compWidth], &val,
+                     td.format.compByteWidth);
+              DELIBERATE_FALLTHROUGH();
+            case 1:
+              memcpy(&subdata[0][(y * td.width + x) * pixelStride + 0 * compWidth], &val,
+                     td.format.compByteWidth);
+              break;
+          }
         }
       }
-    }
+    });
   }
 
   // handle formats that don't support alpha
@@ -1133,46 +1322,58 @@ ResultDetails ReplayController::SaveTexture(const TextureSave &saveData, const r
   {
     byte *nonalpha = new byte[td.width * td.height * 3];
 
-    for(uint32_t y = 0; y < td.height; y++)
+    // the blend colours are constant so convert them once up front rather than per-pixel
+    Vec4f blendCol[2] = {
+        Vec4f(sd.alphaCol.x, sd.alphaCol.y, sd.alphaCol.z),
+        Vec4f(sd.alphaCol.x, sd.alphaCol.y, sd.alphaCol.z),
+    };
+
+    if(sd.alpha == AlphaMapping::BlendToCheckerboard)
     {
-      for(uint32_t x = 0; x < td.width; x++)
-      {
-        byte r = subdata[0][(y * td.width + x) * 4 + 0];
-        byte g = subdata[0][(y * td.width + x) * 4 + 1];
-        byte b = subdata[0][(y * td.width + x) * 4 + 2];
-        byte a = subdata[0][(y * td.width + x) * 4 + 3];
+      blendCol[0] = RenderDoc::Inst().DarkCheckerboardColor();
+      blendCol[1] = RenderDoc::Inst().LightCheckerboardColor();
+    }
 
-        if(sd.alpha != AlphaMapping::Discard)
+    for(Vec4f &col : blendCol)
+    {
+      col.x = ConvertLinearToSRGB(col.x);
+      col.y = ConvertLinearToSRGB(col.y);
+      col.z = ConvertLinearToSRGB(col.z);
+    }
+
+    ForEachRowStrip(td.height, [&](uint32_t y0, uint32_t y1) {
+      for(uint32_t y = y0; y < y1; y++)
+      {
+        for(uint32_t x = 0; x < td.width; x++)
         {
-          Vec4f col = Vec4f(sd.alphaCol.x, sd.alphaCol.y, sd.alphaCol.z);
-          if(sd.alpha == AlphaMapping::BlendToCheckerboard)
+          byte r = subdata[0][(y * td.width + x) * 4 + 0];
+          byte g = subdata[0][(y * td.width + x) * 4 + 1];
+          byte b = subdata[0][(y * td.width + x) * 4 + 2];
+          byte a = subdata[0][(y * td.width + x) * 4 + 3];
+
+          if(sd.alpha != AlphaMapping::Discard)
           {
             bool lightSquare = ((x / 64) % 2) == ((y / 64) % 2);
-            col = lightSquare ? RenderDoc::Inst().LightCheckerboardColor()
-                              : RenderDoc::Inst().DarkCheckerboardColor();
-          }
+            const Vec4f &col = blendCol[lightSquare ? 1 : 0];
 
-          col.x = ConvertLinearToSRGB(col.x);
-          col.y = ConvertLinearToSRGB(col.y);
-          col.z = ConvertLinearToSRGB(col.z);
+            FloatVector pixel = FloatVector(float(r) / 255.0f, float(g) / 255.0f,
+                                            float(b) / 255.0f, float(a) / 255.0f);
 
-          FloatVector pixel = FloatVector(float(r) / 255.0f, float(g) / 255.0f, float(b) / 255.0f,
-                                          float(a) / 255.0f);
+            pixel.x = pixel.x * pixel.w + col.x * (1.0f - pixel.w);
+            pixel.y = pixel.y * pixel.w + col.y * (1.0f - pixel.w);
+            pixel.z = pixel.z * pixel.w + col.z * (1.0f - pixel.w);
 
-          pixel.x = pixel.x * pixel.w + col.x * (1.0f - pixel.w);
-          pixel.y = pixel.y * pixel.w + col.y * (1.0f - pixel.w);
-          pixel.z = pixel.z * pixel.w + col.z * (1.0f - pixel.w);
+            r = byte(pixel.x * 255.0f);
+            g = byte(pixel.y * 255.0f);
+            b = byte(pixel.z * 255.0f);
+          }
 
-          r = byte(pixel.x * 255.0f);
-          g = byte(pixel.y * 255.0f);
-          b = byte(pixel.z * 255.0f);
+          nonalpha[(y * td.width + x) * 3 + 0] = r;
+          nonalpha[(y * td.width + x) * 3 + 1] = g;
+          nonalpha[(y * td.width + x) * 3 + 2] = b;
         }
-
-        nonalpha[(y * td.width + x) * 3 + 0] = r;
-        nonalpha[(y * td.width + x) * 3 + 1] = g;
-        nonalpha[(y * td.width + x) * 3 + 2] = b;
       }
-    }
+    });
 
     delete[] subdata[0];
 
@@ -1188,22 +1389,24 @@ ResultDetails ReplayController::SaveTexture(const TextureSave &saveData, const r
   {
     byte *rg0 = new byte[td.width * td.height * 3];
 
-    for(uint32_t y = 0; y < td.height; y++)
-    {
-      for(uint32_t x = 0; x < td.width; x++)
+    ForEachRowStrip(td.height, [&](uint32_t y0, uint32_t y1) {
+      for(uint32_t y = y0; y < y1; y++)
       {
-        byte r = subdata[0][(y * td.width + x) * 2 + 0];
-        byte g = subdata[0][(y * td.width + x) * 2 + 1];
+        for(uint32_t x = 0; x < td.width; x++)
+        {
+          byte r = subdata[0][(y * td.width + x) * 2 + 0];
+          byte g = subdata[0][(y * td.width + x) * 2 + 1];
 
-        rg0[(y * td.width + x) * 3 + 0] = r;
-        rg0[(y * td.width + x) * 3 + 1] = g;
-        rg0[(y * td.width + x) * 3 + 2] = 0;
+          rg0[(y * td.width + x) * 3 + 0] = r;
+          rg0[(y * td.width + x) * 3 + 1] = g;
+          rg0[(y * td.width + x) * 3 + 2] = 0;
 
-        // if we're greyscaling the image, then keep the greyscale here.
-        if(sd.channelExtract >= 0)
-          rg0[(y * td.width + x) * 3 + 2] = r;
+          // if we're greyscaling the image, then keep the greyscale here.
+          if(sd.channelExtract >= 0)
+            rg0[(y * td.width + x) * 3 + 2] = r;
+        }
       }
-    }
+    });
 
     delete[] subdata[0];
 
@@ -1213,6 +1416,29 @@ ResultDetails ReplayController::SaveTexture(const TextureSave &saveData, const r
     rowPitch = td.width * 3;
   }
 
+  if(blockCompress)
+  {
+    for(size_t i = 0; i < subdata.size(); i++)
+    {
+      bytebuf blocks;
+      if(!BlockCompress(compressFmt, sd.blockCompressionQuality, (const FloatVector *)subdata[i],
+                        subdims[i].first, subdims[i].second, blocks))
+      {
+        for(size_t j = 0; j < subdata.size(); j++)
+          delete[] subdata[j];
+
+        RETURN_ERROR_RESULT(ResultCode::InternalError, "Failed to block compress to %s",
+                            compressFmt.Name().c_str());
+      }
+
+      delete[] subdata[i];
+      subdata[i] = new byte[blocks.size()];
+      memcpy(subdata[i], blocks.data(), blocks.size());
+    }
+
+    td.format = compressFmt;
+  }
+
   FILE *f = FileIO::fopen(path, FileIO::WriteBinary);
 
   RDResult res;
@@ -1324,59 +1550,66 @@ ResultDetails ReplayController::SaveTexture(const TextureSave &saveData, const r
       if(saveFmt.compType == CompType::Depth && pixStride == 3)
         pixStride = 4;
 
-      for(uint32_t y = 0; y < td.height; y++)
-      {
-        for(uint32_t x = 0; x < td.width; x++)
-        {
-          FloatVector pixel = DecodeFormattedComponents(saveFmt, srcData);
-          srcData += pixStride;
-
-          // HDR can't represent negative values
-          if(sd.destType == FileType::HDR)
-          {
-            pixel.x = RDCMAX(pixel.x, 0.0f);
-            pixel.y = RDCMAX(pixel.y, 0.0f);
-            pixel.z = RDCMAX(pixel.z, 0.0f);
-            pixel.w = RDCMAX(pixel.w, 0.0f);
-          }
+      ForEachRowStrip(td.height, [&](uint32_t y0, uint32_t y1) {
+        rdcarray<FloatVector> row;
+        row.resize(td.width);
 
-          if(sd.channelExtract == 0)
-          {
-            pixel.y = pixel.z = pixel.x;
-            pixel.w = 1.0f;
-          }
-          else if(sd.channelExtract == 1)
-          {
-            pixel.x = pixel.z = pixel.y;
-            pixel.w = 1.0f;
-          }
-          else if(sd.channelExtract == 2)
-          {
-            pixel.x = pixel.y = pixel.z;
-            pixel.w = 1.0f;
-          }
-          else if(sd.channelExtract == 3)
-          {
-            pixel.x = pixel.y = pixel.z = pixel.w;
-            pixel.w = 1.0f;
-          }
+        for(uint32_t y = y0; y < y1; y++)
+        {
+          DecodeFormattedComponentsRow(saveFmt, srcData + pixStride * td.width * y, pixStride,
+                                       td.width, row.data());
 
-          if(fldata)
-          {
-            fldata[(y * td.width + x) * 4 + 0] = pixel.x;
-            fldata[(y * td.width + x) * 4 + 1] = pixel.y;
-            fldata[(y * td.width + x) * 4 + 2] = pixel.z;
-            fldata[(y * td.width + x) * 4 + 3] = pixel.w;
-          }
-          else
+          for(uint32_t x = 0; x < td.width; x++)
           {
-            abgr[0][(y * td.width + x)] = pixel.w;
-            abgr[1][(y * td.width + x)] = pixel.z;
-            abgr[2][(y * td.width + x)] = pixel.y;
-            abgr[3][(y * td.width + x)] = pixel.x;
+            FloatVector pixel = row[x];
+
+            // HDR can't represent negative values
+            if(sd.destType == FileType::HDR)
+            {
+              pixel.x = RDCMAX(pixel.x, 0.0f);
+              pixel.y = RDCMAX(pixel.y, 0.0f);
+              pixel.z = RDCMAX(pixel.z, 0.0f);
+              pixel.w = RDCMAX(pixel.w, 0.0f);
+            }
+
+            if(sd.channelExtract == 0)
+            {
+              pixel.y = pixel.z = pixel.x;
+              pixel.w = 1.0f;
+            }
+            else if(sd.channelExtract == 1)
+            {
+              pixel.x = pixel.z = pixel.y;
+              pixel.w = 1.0f;
+            }
+            else if(sd.channelExtract == 2)
+            {
+              pixel.x = pixel.y = pixel.z;
+              pixel.w = 1.0f;
+            }
+            else if(sd.channelExtract == 3)
+            {
+              pixel.x = pixel.y = pixel.z = pixel.w;
+              pixel.w = 1.0f;
+            }
+
+            if(fldata)
+            {
+              fldata[(y * td.width + x) * 4 + 0] = pixel.x;
+              fldata[(y * td.width + x) * 4 + 1] = pixel.y;
+              fldata[(y * td.width + x) * 4 + 2] = pixel.z;
+              fldata[(y * td.width + x) * 4 + 3] = pixel.w;
+            }
+            else
+            {
+              abgr[0][(y * td.width + x)] = pixel.w;
+              abgr[1][(y * td.width + x)] = pixel.z;
+              abgr[2][(y * td.width + x)] = pixel.y;
+              abgr[3][(y * td.width + x)] = pixel.x;
+            }
           }
         }
-      }
+      });
 
       if(sd.destType == FileType::HDR)
       {
@@ -2245,6 +2478,7 @@ void ReplayController::FileChanged()
 {
   CHECK_REPLAY_THREAD();
 
+  m_PrefetchedEvents.clear();
   m_pDevice->FileChanged();
 }
 
@@ -2261,8 +2495,27 @@ void ReplayController::FetchPipelineState(uint32_t eventId)
 
   RENDERDOC_PROFILEFUNCTION();
 
-  m_pDevice->SavePipelineState(eventId);
-  FatalErrorCheck();
+  PrefetchedEvent *prefetch = NULL;
+  for(PrefetchedEvent &p : m_PrefetchedEvents)
+    if(p.eventId == eventId)
+      prefetch = &p;
+
+  if(prefetch)
+  {
+    if(m_APIProps.pipelineType == GraphicsAPI::D3D11)
+      m_D3D11PipelineState = prefetch->d3d11;
+    else if(m_APIProps.pipelineType == GraphicsAPI::D3D12)
+      m_D3D12PipelineState = prefetch->d3d12;
+    else if(m_APIProps.pipelineType == GraphicsAPI::OpenGL)
+      m_GLPipelineState = prefetch->gl;
+    else if(m_APIProps.pipelineType == GraphicsAPI::Vulkan)
+      m_VulkanPipelineState = prefetch->vk;
+  }
+  else
+  {
+    m_pDevice->SavePipelineState(eventId);
+    FatalErrorCheck();
+  }
 
   if(m_APIProps.pipelineType == GraphicsAPI::D3D11)
     m_PipeState.SetState(&m_D3D11PipelineState);
@@ -2273,50 +2526,126 @@ void ReplayController::FetchPipelineState(uint32_t eventId)
   else if(m_APIProps.pipelineType == GraphicsAPI::Vulkan)
     m_PipeState.SetState(&m_VulkanPipelineState);
 
-  rdcarray<DescriptorAccess> access = m_pDevice->GetDescriptorAccess(eventId);
+  if(prefetch)
+  {
+    m_PipeState.SetDescriptorAccess(std::move(prefetch->access), std::move(prefetch->descriptors),
+                                    std::move(prefetch->samplerDescriptors));
+    m_PrefetchedEvents.erase(prefetch - m_PrefetchedEvents.data());
+    return;
+  }
+
+  rdcarray<DescriptorAccess> access;
   rdcarray<Descriptor> descs;
   rdcarray<SamplerDescriptor> samps;
+  FetchDescriptors(eventId, access, descs, samps);
+
+  m_PipeState.SetDescriptorAccess(std::move(access), std::move(descs), std::move(samps));
+}
+
+void ReplayController::FetchDescriptors(uint32_t eventId, rdcarray<DescriptorAccess> &access,
+                                        rdcarray<Descriptor> &descs,
+                                        rdcarray<SamplerDescriptor> &samps)
+{
+  access = m_pDevice->GetDescriptorAccess(eventId);
+  descs.clear();
+  samps.clear();
   descs.reserve(access.size());
   samps.reserve(access.size());
 
-  // we could collate ranges by descriptor store, but in practice we don't expect descriptors to be
-  // scattered across multiple stores. So to keep the code simple for now we do a linear sweep
-  ResourceId store;
-  rdcarray<DescriptorRange> ranges;
-
-  for(const DescriptorAccess &acc : access)
+  for(const DescriptorAccessRanges &group : CollateDescriptorAccess(access))
   {
-    if(acc.descriptorStore != store)
-    {
-      if(store != ResourceId())
-      {
-        descs.append(m_pDevice->GetDescriptors(store, ranges));
-        samps.append(m_pDevice->GetSamplerDescriptors(store, ranges));
-      }
+    ResourceId store = m_pDevice->GetLiveID(group.descriptorStore);
 
-      store = m_pDevice->GetLiveID(acc.descriptorStore);
-      ranges.clear();
+    if(store != ResourceId())
+    {
+      descs.append(m_pDevice->GetDescriptors(store, group.ranges));
+      samps.append(m_pDevice->GetSamplerDescriptors(store, group.ranges));
     }
+  }
+}
 
-    // if the last range is contiguous with this access, append this access as a new range to query
-    if(!ranges.empty() && ranges.back().descriptorSize == acc.byteSize &&
-       ranges.back().offset + ranges.back().descriptorSize == acc.byteOffset)
+#if ENABLED(ENABLE_UNIT_TESTS)
+
+#include "catch/catch.hpp"
+
+TEST_CASE("Check parallel PNG deflate round-trips", "[image]")
+{
+  // big enough for several deflate strips, with a non-multiple height to get a partial last strip
+  const int width = 1024, height = 301;
+
+  bytebuf pixels;
+  pixels.resize(width * height * 4);
+
+  // mix of compressible gradients and noise
+  uint32_t seed = 12345;
+  for(int y = 0; y < height; y++)
+  {
+    for(int x = 0; x < width; x++)
     {
-      ranges.back().count++;
-      continue;
-    }
+      seed = seed * 1103515245 + 12345;
 
-    DescriptorRange range;
-    range.offset = acc.byteOffset;
-    range.descriptorSize = acc.byteSize;
-    ranges.push_back(range);
+      byte *pix = &pixels[(y * width + x) * 4];
+      pix[0] = byte(x);
+      pix[1] = byte(y);
+      pix[2] = byte(seed >> 16);
+      pix[3] = (x / 64) % 2 ? 255 : byte(seed >> 24);
+    }
   }
 
-  if(store != ResourceId())
+  SECTION("zlib stream")
   {
-    descs.append(m_pDevice->GetDescriptors(store, ranges));
-    samps.append(m_pDevice->GetSamplerDescriptors(store, ranges));
-  }
+    int compLen = 0;
+    unsigned char *comp = rdoc_stbiw_zlib_compress(pixels.data(), (int)pixels.size(), &compLen, 8);
 
-  m_PipeState.SetDescriptorAccess(std::move(access), std::move(descs), std::move(samps));
+    REQUIRE(comp);
+
+    bytebuf decomp;
+    decomp.resize(pixels.size());
+    mz_ulong decompLen = (mz_ulong)decomp.size();
+
+    CHECK(mz_uncompress(decomp.data(), &decompLen, comp, (mz_ulong)compLen) == (int)MZ_OK);
+    CHECK(decompLen == pixels.size());
+    CHECK(decomp == pixels);
+
+    free(comp);
+  };
+
+  SECTION("Empty input")
+  {
+    int compLen = 0;
+    unsigned char *comp = rdoc_stbiw_zlib_compress(NULL, 0, &compLen, 8);
+
+    REQUIRE(comp);
+
+    byte dummy = 0;
+    mz_ulong decompLen = 1;
+    CHECK(mz_uncompress(&dummy, &decompLen, comp, (mz_ulong)compLen) == (int)MZ_OK);
+    CHECK(decompLen == 0);
+
+    free(comp);
+  };
+
+  SECTION("PNG file")
+  {
+    bytebuf png;
+    int ret = stbi_write_png_to_func(
+        [](void *context, void *data, int size) {
+          ((bytebuf *)context)->append((const byte *)data, size);
+        },
+        &png, width, height, 4, pixels.data(), width * 4);
+
+    REQUIRE(ret != 0);
+
+    int w = 0, h = 0, comps = 0;
+    byte *decoded = stbi_load_from_memory(png.data(), (int)png.size(), &w, &h, &comps, 4);
+
+    REQUIRE(decoded);
+    CHECK(w == width);
+    CHECK(h == height);
+    CHECK(memcmp(decoded, pixels.data(), pixels.size()) == 0);
+
+    stbi_image_free(decoded);
+  };
 }
+
+#endif    // ENABLED(ENABLE_UNIT_TESTS)
@@ -144,6 +144,7 @@ public:
   void FileChanged();
 
   void SetFrameEvent(uint32_t eventId, bool force);
+  void PrefetchFrameEvent(uint32_t eventId);
 
   const D3D11Pipe::State *GetD3D11PipelineState();
   const D3D12Pipe::State *GetD3D12PipelineState();
@@ -250,6 +251,8 @@ private:
   RDResult PostCreateInit(IReplayDriver *device, RDCFile *rdc);
 
   void FetchPipelineState(uint32_t eventId);
+  void FetchDescriptors(uint32_t eventId, rdcarray<DescriptorAccess> &access,
+                        rdcarray<Descriptor> &descs, rdcarray<SamplerDescriptor> &samps);
 
   ActionDescription *GetActionByEID(uint32_t eventId);
   bool ContainsMarker(const rdcarray<ActionDescription> &actions);
@@ -280,6 +283,21 @@ private:
   VKPipe::State m_VulkanPipelineState;
   PipeState m_PipeState;
 
+  // pipeline state fetched ahead of time with PrefetchFrameEvent, used the next time we move to
+  // that event. Only the state for the current API is filled out.
+  struct PrefetchedEvent
+  {
+    uint32_t eventId = 0;
+    D3D11Pipe::State d3d11;
+    D3D12Pipe::State d3d12;
+    GLPipe::State gl;
+    VKPipe::State vk;
+    rdcarray<DescriptorAccess> access;
+    rdcarray<Descriptor> descriptors;
+    rdcarray<SamplerDescriptor> samplerDescriptors;
+  };
+  rdcarray<PrefetchedEvent> m_PrefetchedEvents;
+
   rdcarray<ReplayOutput *> m_Outputs;
 
   rdcarray<ResourceDescription> m_Resources;
@@ -24,12 +24,13 @@
 
 #include "replay_driver.h"
 #include <float.h>
+#include <algorithm>
 #include <math.h>
-#include "compressonator/CMP_Core.h"
 #include "maths/formatpacking.h"
 #include "maths/half_convert.h"
 #include "serialise/serialiser.h"
 #include "strings/string_utils.h"
+#include "block_compress.h"
 
 template <>
 rdcstr DoStringise(const RemapTexture &el)
@@ -789,6 +790,200 @@ uint64_t CalcMeshOutputSize(uint64_t curSize, uint64_t requiredOutput)
   return curSize;
 }
 
+rdcarray<DescriptorAccessRanges> CollateDescriptorAccess(const rdcarray<DescriptorAccess> &access)
+{
+  rdcarray<DescriptorAccessRanges> ret;
+
+  // we could collate ranges by descriptor store, but in practice we don't expect descriptors to be
+  // scattered across multiple stores. So to keep the code simple for now we do a linear sweep
+  for(const DescriptorAccess &acc : access)
+  {
+    if(ret.empty() || ret.back().descriptorStore != acc.descriptorStore)
+    {
+      ret.push_back({});
+      ret.back().descriptorStore = acc.descriptorStore;
+    }
+
+    rdcarray<DescriptorRange> &ranges = ret.back().ranges;
+
+    // if the last range is contiguous with this access, append this access as a new range to query
+    if(!ranges.empty() && ranges.back().descriptorSize == acc.byteSize &&
+       ranges.back().offset + ranges.back().descriptorSize * ranges.back().count == acc.byteOffset)
+    {
+      ranges.back().count++;
+      continue;
+    }
+
+    ranges.push_back(DescriptorRange(acc));
+  }
+
+  return ret;
+}
+
+template <typename IndexType>
+static void DeduplicateIndices(IndexType *idx, uint32_t numIndices, int32_t baseVertex,
+                               uint32_t maxIndex, uint32_t restartIndex, bool addZero,
+                               rdcarray<uint32_t> &uniqueIndices)
+{
+  const uint64_t clamp = baseVertex < 0 ? uint64_t(-int64_t(baseVertex)) : 0;
+  const uint64_t offset = baseVertex > 0 ? uint64_t(baseVertex) : 0;
+
+  auto rebase = [=](uint32_t i32) -> uint32_t {
+    uint64_t i64 = i32;
+    i64 = i64 < clamp ? 0 : i64 - clamp + offset;
+    return uint32_t(RDCMIN(uint64_t(maxIndex), i64));
+  };
+
+  // find the range of referenced indices to decide how to track them
+  uint32_t minIdx = addZero ? 0 : ~0U, maxIdx = 0;
+  uint32_t numUsed = 0;
+  for(uint32_t i = 0; i < numIndices; i++)
+  {
+    if(restartIndex && idx[i] == restartIndex)
+      continue;
+
+    uint32_t i32 = rebase(idx[i]);
+    minIdx = RDCMIN(minIdx, i32);
+    maxIdx = RDCMAX(maxIdx, i32);
+    numUsed++;
+  }
+
+  if(numUsed == 0)
+  {
+    if(addZero)
+      uniqueIndices.push_back(0);
+    return;
+  }
+
+  const uint64_t range = uint64_t(maxIdx) - minIdx + 1;
+
+  // if the indices are reasonably dense, mark each one in a bitmask. The set falls out sorted, and
+  // the remap is the number of set bits below each index, found with a running count per word.
+  // The bitmask is at most a few bytes per index, so invalid indices like 0xcccccccc don't have us
+  // allocating gigabytes.
+  if(range <= RDCMAX(uint64_t(numIndices) * 32, uint64_t(1) << 20))
+  {
+    rdcarray<uint32_t> bits;
+    bits.resize(size_t((range + 31) / 32));
+
+    if(addZero)
+      bits[0] |= 1U;
+
+    for(uint32_t i = 0; i < numIndices; i++)
+    {
+      if(restartIndex && idx[i] == restartIndex)
+        continue;
+
+      uint32_t bit = rebase(idx[i]) - minIdx;
+      bits[bit / 32] |= 1U << (bit % 32);
+    }
+
+    rdcarray<uint32_t> rank;
+    rank.resize(bits.size());
+
+    uint32_t count = 0;
+    for(size_t w = 0; w < bits.size(); w++)
+    {
+      rank[w] = count;
+      count += Bits::CountOnes(bits[w]);
+    }
+
+    uniqueIndices.reserve(count);
+    for(size_t w = 0; w < bits.size(); w++)
+    {
+      uint32_t word = bits[w];
+      while(word)
+      {
+        uint32_t b = Bits::CountTrailingZeroes(word);
+        uniqueIndices.push_back(minIdx + uint32_t(w) * 32 + b);
+        word &= word - 1;
+      }
+    }
+
+    for(uint32_t i = 0; i < numIndices; i++)
+    {
+      if(restartIndex && idx[i] == restartIndex)
+        continue;
+
+      uint32_t bit = rebase(idx[i]) - minIdx;
+      uint32_t below = bits[bit / 32] & ((1U << (bit % 32)) - 1);
+      idx[i] = IndexType(rank[bit / 32] + Bits::CountOnes(below));
+    }
+
+    return;
+  }
+
+  // otherwise the indices are sparse. Radix sort them and remove duplicates, then find each index
+  // in the sorted set.
+  rdcarray<uint32_t> sorted, temp;
+  sorted.reserve(numUsed + 1);
+  for(uint32_t i = 0; i < numIndices; i++)
+  {
+    if(restartIndex && idx[i] == restartIndex)
+      continue;
+
+    sorted.push_back(rebase(idx[i]));
+  }
+
+  if(addZero)
+    sorted.push_back(0);
+
+  temp.resize(sorted.size());
+
+  for(uint32_t shift = 0; shift < 32; shift += 8)
+  {
+    uint32_t offsets[256] = {};
+    for(uint32_t i32 : sorted)
+      offsets[(i32 >> shift) & 0xff]++;
+
+    uint32_t total = 0;
+    for(uint32_t &o : offsets)
+    {
+      uint32_t c = o;
+      o = total;
+      total += c;
+    }
+
+    for(uint32_t i32 : sorted)
+      temp[offsets[(i32 >> shift) & 0xff]++] = i32;
+
+    sorted.swap(temp);
+  }
+
+  uniqueIndices.reserve(sorted.size());
+  for(size_t i = 0; i < sorted.size(); i++)
+  {
+    if(i == 0 || sorted[i] != sorted[i - 1])
+      uniqueIndices.push_back(sorted[i]);
+  }
+
+  for(uint32_t i = 0; i < numIndices; i++)
+  {
+    if(restartIndex && idx[i] == restartIndex)
+      continue;
+
+    auto it = std::lower_bound(uniqueIndices.begin(), uniqueIndices.end(), rebase(idx[i]));
+    idx[i] = IndexType(it - uniqueIndices.begin());
+  }
+}
+
+void DeduplicateIndices(byte *idxdata, uint32_t indexWidth, uint32_t numIndices, int32_t baseVertex,
+                        uint32_t maxIndex, uint32_t restartIndex, bool addZero,
+                        rdcarray<uint32_t> &uniqueIndices)
+{
+  uniqueIndices.clear();
+
+  if(indexWidth == 1)
+    DeduplicateIndices((uint8_t *)idxdata, numIndices, baseVertex, maxIndex, restartIndex & 0xff,
+                       addZero, uniqueIndices);
+  else if(indexWidth == 2)
+    DeduplicateIndices((uint16_t *)idxdata, numIndices, baseVertex, maxIndex,
+                       restartIndex & 0xffff, addZero, uniqueIndices);
+  else
+    DeduplicateIndices((uint32_t *)idxdata, numIndices, baseVertex, maxIndex, restartIndex, addZero,
+                       uniqueIndices);
+}
+
 FloatVector HighlightCache::InterpretVertex(const byte *data, uint32_t vert, const MeshDisplay &cfg,
                                             const byte *end, bool useidx, bool &valid)
 {
@@ -1665,110 +1860,34 @@ bytebuf GetDiscardPattern(DiscardType type, const ResourceFormat &fmt, uint32_t
           fmt.type == ResourceFormatType::BC5 || fmt.type == ResourceFormatType::BC6 ||
           fmt.type == ResourceFormatType::BC7)
   {
-#if ENABLED(RDOC_ANDROID)
-    RDCERR("Format %s not supported on android", fmt.Name().c_str());
-#else
-    const uint16_t whalf = ConvertToHalf(1000.0f);
-
-    byte block[16];
-
-    uint32_t blockSize =
-        fmt.type == ResourceFormatType::BC1 || fmt.type == ResourceFormatType::BC4 ? 8 : 16;
-    uint32_t tightPitch = (DiscardPatternWidth / 4) * blockSize;
-    rowPitch = RDCMAX(rowPitch, tightPitch);
-
-    ret.reserve(rowPitch * (DiscardPatternHeight / 4));
+    // BC6 is HDR so use a large value, BC1-5 and 7 will clamp to 1.0
+    const float white = fmt.type == ResourceFormatType::BC6 ? 1000.0f : 1.0f;
 
-    bytebuf inblock;
+    rdcarray<FloatVector> pixels;
+    pixels.resize(DiscardPatternWidth * DiscardPatternHeight);
 
-    void *bc6opts = NULL;
-
-    CreateOptionsBC6(&bc6opts);
-
-    SetQualityBC6(bc6opts, 0.1f);
-
-    for(uint32_t yi = 0; yi < DiscardPatternHeight; yi += 4)
+    for(uint32_t yi = 0; yi < DiscardPatternHeight; yi++)
     {
-      uint32_t baseY = invert ? DiscardPatternHeight - 1 - yi : yi;
-
-      for(uint32_t baseX = 0; baseX < DiscardPatternWidth; baseX += 4)
+      uint32_t y = invert ? DiscardPatternHeight - 1 - yi : yi;
+      for(uint32_t x = 0; x < DiscardPatternWidth; x++)
       {
-        inblock.clear();
-
-        // inblock is 4x4 RGBA8_UNORM
-        if(fmt.type == ResourceFormatType::BC1 || fmt.type == ResourceFormatType::BC2 ||
-           fmt.type == ResourceFormatType::BC3 || fmt.type == ResourceFormatType::BC7)
-        {
-          for(uint32_t y = baseY; y < baseY + 4; invert ? y-- : y++)
-          {
-            for(uint32_t x = baseX; x < baseX + 4; x++)
-            {
-              char c = pattern.c_str()[y * DiscardPatternWidth + x];
-
-              inblock.push_back(c == '#' ? 0xff : 0x00);
-              inblock.push_back(c == '#' ? 0xff : 0x00);
-              inblock.push_back(c == '#' ? 0xff : 0x00);
-              inblock.push_back(c == '#' ? 0xff : 0x00);
-            }
-          }
-        }
-        // inblock is 4x4 R8_UNORM
-        else if(fmt.type == ResourceFormatType::BC4 || fmt.type == ResourceFormatType::BC5)
-        {
-          for(uint32_t y = baseY; y < baseY + 4; invert ? y-- : y++)
-          {
-            for(uint32_t x = baseX; x < baseX + 4; x++)
-            {
-              char c = pattern.c_str()[y * DiscardPatternWidth + x];
-
-              inblock.push_back(c == '#' ? 0xff : 0x00);
-            }
-          }
-        }
-        // inblock is 4x4 RGB16_FLOAT
-        else if(fmt.type == ResourceFormatType::BC6)
-        {
-          for(uint32_t y = baseY; y < baseY + 4; invert ? y-- : y++)
-          {
-            for(uint32_t x = baseX; x < baseX + 4; x++)
-            {
-              char c = pattern.c_str()[y * DiscardPatternWidth + x];
-
-              inblock.push_back(c == '#' ? (whalf & 0xff) : 0x00);
-              inblock.push_back(c == '#' ? ((whalf >> 8) & 0xff) : 0x00);
-
-              inblock.push_back(c == '#' ? (whalf & 0xff) : 0x00);
-              inblock.push_back(c == '#' ? ((whalf >> 8) & 0xff) : 0x00);
+        float v = pattern.c_str()[y * DiscardPatternWidth + x] == '#' ? white : 0.0f;
+        pixels[yi * DiscardPatternWidth + x] = FloatVector(v, v, v, v);
+      }
+    }
 
-              inblock.push_back(c == '#' ? (whalf & 0xff) : 0x00);
-              inblock.push_back(c == '#' ? ((whalf >> 8) & 0xff) : 0x00);
-            }
-          }
-        }
+    bytebuf blocks;
+    if(BlockCompress(fmt, QualityHint::DontCare, pixels.data(), DiscardPatternWidth,
+                     DiscardPatternHeight, blocks))
+    {
+      uint32_t tightPitch = (DiscardPatternWidth / 4) * GetBlockCompressedSize(fmt.type);
+      rowPitch = RDCMAX(rowPitch, tightPitch);
 
-        if(fmt.type == ResourceFormatType::BC1)
-          CompressBlockBC1(inblock.data(), 4 * sizeof(uint32_t), block, NULL);
-        else if(fmt.type == ResourceFormatType::BC2)
-          CompressBlockBC2(inblock.data(), 4 * sizeof(uint32_t), block, NULL);
-        else if(fmt.type == ResourceFormatType::BC3)
-          CompressBlockBC3(inblock.data(), 4 * sizeof(uint32_t), block, NULL);
-        else if(fmt.type == ResourceFormatType::BC4)
-          CompressBlockBC4(inblock.data(), 4, block, NULL);
-        else if(fmt.type == ResourceFormatType::BC5)
-          CompressBlockBC5(inblock.data(), 4, inblock.data(), 4, block, NULL);
-        else if(fmt.type == ResourceFormatType::BC6)
-          CompressBlockBC6((uint16_t *)inblock.data(), 4 * 3, block, bc6opts);
-        else if(fmt.type == ResourceFormatType::BC7)
-          CompressBlockBC7(inblock.data(), 4 * sizeof(uint32_t), block, NULL);
-
-        ret.append(block, blockSize);
-      }
+      ret.resize(rowPitch * (DiscardPatternHeight / 4));
 
-      ret.resize(ret.size() + (rowPitch - tightPitch));
+      for(uint32_t by = 0; by < DiscardPatternHeight / 4; by++)
+        memcpy(ret.data() + by * rowPitch, blocks.data() + by * tightPitch, tightPitch);
     }
-
-    DestroyOptionsBC6(bc6opts);
-#endif
   }
   else if(fmt.type == ResourceFormatType::ETC2 || fmt.type == ResourceFormatType::EAC ||
           fmt.type == ResourceFormatType::ASTC || fmt.type == ResourceFormatType::PVRTC ||
@@ -1857,3 +1976,234 @@ void DeriveNearFar(Vec4f pos, Vec4f pos0, float &nearp, float &farp, bool &found
     found = true;
   }
 }
+
+#if ENABLED(ENABLE_UNIT_TESTS)
+
+#include <map>
+#include <set>
+#include "catch/catch.hpp"
+
+// the original set-and-map based deduplication, as a reference
+static void ReferenceDeduplicateIndices(bytebuf &idxdata, uint32_t indexWidth, int32_t baseVertex,
+                                        uint32_t maxIndex, uint32_t restartIndex, bool addZero,
+                                        rdcarray<uint32_t> &uniqueIndices)
+{
+  uint32_t numIndices = uint32_t(idxdata.size() / indexWidth);
+  restartIndex &= 0xffffffff >> ((4 - indexWidth) * 8);
+
+  auto read = [&](uint32_t i) -> uint32_t {
+    uint32_t ret = 0;
+    memcpy(&ret, idxdata.data() + i * indexWidth, indexWidth);
+    return ret;
+  };
+  auto rebase = [&](uint32_t i32) -> uint32_t {
+    int64_t i64 = int64_t(i32) + baseVertex;
+    return uint32_t(RDCCLAMP(i64, int64_t(0), int64_t(maxIndex)));
+  };
+
+  std::set<uint32_t> set;
+  for(uint32_t i = 0; i < numIndices; i++)
+    if(!restartIndex || read(i) != restartIndex)
+      set.insert(rebase(read(i)));
+
+  if(addZero)
+    set.insert(0);
+
+  std::map<uint32_t, uint32_t> remap;
+  uniqueIndices.clear();
+  for(uint32_t i32 : set)
+  {
+    remap[i32] = (uint32_t)uniqueIndices.size();
+    uniqueIndices.push_back(i32);
+  }
+
+  for(uint32_t i = 0; i < numIndices; i++)
+  {
+    uint32_t i32 = read(i);
+    if(restartIndex && i32 == restartIndex)
+      continue;
+    i32 = remap[rebase(i32)];
+    memcpy(idxdata.data() + i * indexWidth, &i32, indexWidth);
+  }
+}
+
+TEST_CASE("Index deduplication", "[mesh]")
+{
+  uint32_t seed = 0x1234567;
+  auto rand32 = [&seed]() {
+    seed = seed * 1664525U + 1013904223U;
+    return seed >> 8;
+  };
+
+  SECTION("Empty and restart-only index buffers")
+  {
+    rdcarray<uint32_t> unique;
+
+    bytebuf idxdata;
+    DeduplicateIndices(idxdata.data(), 2, 0, 0, ~0U, 0xffff, false, unique);
+    CHECK(unique.empty());
+
+    DeduplicateIndices(idxdata.data(), 2, 0, 0, ~0U, 0xffff, true, unique);
+    CHECK(unique == rdcarray<uint32_t>({0}));
+
+    uint16_t restarts[] = {0xffff, 0xffff};
+    DeduplicateIndices((byte *)restarts, 2, 2, 0, ~0U, ~0U, false, unique);
+    CHECK(unique.empty());
+    CHECK(restarts[0] == 0xffff);
+    CHECK(restarts[1] == 0xffff);
+  };
+
+  SECTION("Simple remap")
+  {
+    uint32_t indices[] = {500, 501, 502, 501, 510, 502, ~0U, 512};
+
+    rdcarray<uint32_t> unique;
+    DeduplicateIndices((byte *)indices, 4, ARRAY_COUNT(indices), 0, ~0U, ~0U, false, unique);
+
+    CHECK(unique == rdcarray<uint32_t>({500, 501, 502, 510, 512}));
+
+    uint32_t expected[] = {0, 1, 2, 1, 3, 2, ~0U, 4};
+    for(size_t i = 0; i < ARRAY_COUNT(indices); i++)
+      CHECK(indices[i] == expected[i]);
+  };
+
+  SECTION("Matches reference")
+  {
+    for(uint32_t indexWidth : {1U, 2U, 4U})
+    {
+      for(int32_t baseVertex : {0, -100, 1000})
+      {
+        // dense indices, then sparse with invalid garbage mixed in
+        for(uint32_t spread : {200U, 0xffffffffU})
+        {
+          const uint32_t numIndices = 5000;
+
+          bytebuf idxdata;
+          idxdata.resize(numIndices * indexWidth);
+          for(uint32_t i = 0; i < numIndices; i++)
+          {
+            uint32_t i32 = rand32() % 200;
+            if(spread != 200 && (rand32() % 4) == 0)
+              i32 = rand32() * 251;
+            if((rand32() % 50) == 0)
+              i32 = ~0U;
+            memcpy(idxdata.data() + i * indexWidth, &i32, indexWidth);
+          }
+
+          for(bool addZero : {false, true})
+          {
+            bytebuf expectedData = idxdata, actualData = idxdata;
+            rdcarray<uint32_t> expected, actual;
+
+            ReferenceDeduplicateIndices(expectedData, indexWidth, baseVertex, 0x7fffffff, ~0U,
+                                        addZero, expected);
+            DeduplicateIndices(actualData.data(), indexWidth, numIndices, baseVertex, 0x7fffffff,
+                               ~0U, addZero, actual);
+
+            CHECK(actual == expected);
+            CHECK(actualData == expectedData);
+          }
+        }
+      }
+    }
+  };
+}
+
+TEST_CASE("Descriptor access collation", "[descriptors]")
+{
+  ResourceId storeA = ResourceIDGen::GetNewUniqueID();
+  ResourceId storeB = ResourceIDGen::GetNewUniqueID();
+
+  auto makeAccess = [](ResourceId store, uint32_t offset, uint32_t size) {
+    DescriptorAccess acc;
+    acc.descriptorStore = store;
+    acc.byteOffset = offset;
+    acc.byteSize = size;
+    return acc;
+  };
+
+  SECTION("Empty")
+  {
+    CHECK(CollateDescriptorAccess({}).empty());
+  };
+
+  SECTION("Contiguous accesses merge into one range")
+  {
+    rdcarray<DescriptorAccessRanges> groups = CollateDescriptorAccess({
+        makeAccess(storeA, 0, 16), makeAccess(storeA, 16, 16), makeAccess(storeA, 32, 16),
+        makeAccess(storeA, 48, 16),
+    });
+
+    REQUIRE(groups.size() == 1);
+    CHECK(groups[0].descriptorStore == storeA);
+    REQUIRE(groups[0].ranges.size() == 1);
+    CHECK(groups[0].ranges[0].offset == 0);
+    CHECK(groups[0].ranges[0].descriptorSize == 16);
+    CHECK(groups[0].ranges[0].count == 4);
+  };
+
+  SECTION("Gaps, size changes and store changes split ranges")
+  {
+    rdcarray<DescriptorAccessRanges> groups = CollateDescriptorAccess({
+        makeAccess(storeA, 0, 16), makeAccess(storeA, 16, 16), makeAccess(storeA, 64, 16),
+        makeAccess(storeA, 80, 8), makeAccess(storeB, 88, 8), makeAccess(storeB, 96, 8),
+        makeAccess(storeA, 96, 8),
+    });
+
+    REQUIRE(groups.size() == 3);
+    CHECK(groups[0].descriptorStore == storeA);
+    CHECK(groups[1].descriptorStore == storeB);
+    CHECK(groups[2].descriptorStore == storeA);
+
+    REQUIRE(groups[0].ranges.size() == 3);
+    CHECK(groups[0].ranges[0].count == 2);
+    CHECK(groups[0].ranges[1].offset == 64);
+    CHECK(groups[0].ranges[1].count == 1);
+    CHECK(groups[0].ranges[2].descriptorSize == 8);
+
+    REQUIRE(groups[1].ranges.size() == 1);
+    CHECK(groups[1].ranges[0].offset == 88);
+    CHECK(groups[1].ranges[0].count == 2);
+
+    // every access is covered exactly once
+    uint32_t total = 0;
+    for(const DescriptorAccessRanges &group : groups)
+      for(const DescriptorRange &range : group.ranges)
+        total += range.count;
+    CHECK(total == 7);
+  };
+}
+
+TEST_CASE("Benchmark index deduplication", "[.][mesh][benchmark]")
+{
+  const uint32_t numIndices = 3 * 1024 * 1024;
+
+  // a large grid mesh with good vertex reuse, then the same with some garbage indices that force
+  // the sparse path
+  for(bool sparse : {false, true})
+  {
+    rdcarray<uint32_t> indices;
+    indices.resize(numIndices);
+    for(uint32_t i = 0; i < numIndices; i++)
+    {
+      uint32_t quad = i / 6, corner = i % 6;
+      uint32_t x = quad % 1024, y = quad / 1024;
+      const uint32_t cornerX[] = {0, 1, 0, 0, 1, 1}, cornerY[] = {0, 0, 1, 1, 0, 1};
+      indices[i] = (y + cornerY[corner]) * 1025 + x + cornerX[corner];
+
+      if(sparse && (i % 997) == 0)
+        indices[i] = i * 2654435761U;
+    }
+
+    rdcarray<uint32_t> unique;
+
+    PerformanceTimer timer;
+    DeduplicateIndices((byte *)indices.data(), 4, numIndices, 0, ~0U, ~0U, false, unique);
+    double dedupTime = timer.GetMilliseconds();
+
+    RDCLOG("%s: %u indices -> %u unique in %.2f ms", sparse ? "sparse" : "dense", numIndices,
+           (uint32_t)unique.size(), dedupTime);
+  }
+}
+
+#endif
@@ -340,6 +340,28 @@ void PatchTriangleFanRestartIndexBufer(rdcarray<uint32_t> &patchedIndices, uint3
 
 uint64_t CalcMeshOutputSize(uint64_t curSize, uint64_t requiredOutput);
 
+// gathers the sorted set of unique vertex indices referenced by an index buffer, and remaps the
+// index buffer in place so each index points at its element in that set. baseVertex is applied
+// to each index first, clamped to [0, maxIndex]. Indices equal to restartIndex (masked to the
+// index width, 0 to disable) are left untouched and not added to the set. If addZero is true,
+// vertex 0 is always included, e.g. when reading past the end of the index buffer returned 0s.
+void DeduplicateIndices(byte *idxdata, uint32_t indexWidth, uint32_t numIndices, int32_t baseVertex,
+                        uint32_t maxIndex, uint32_t restartIndex, bool addZero,
+                        rdcarray<uint32_t> &uniqueIndices);
+
+// a run of consecutive descriptor accesses in the same store, coalesced into ranges to query
+struct DescriptorAccessRanges
+{
+  // the descriptor store as reported in the access, this must be mapped with GetLiveID to query
+  ResourceId descriptorStore;
+  rdcarray<DescriptorRange> ranges;
+};
+
+// sweeps the accesses at an event, grouping consecutive accesses to the same store and merging
+// contiguous accesses into ranges. Querying every range in order returns exactly one descriptor
+// per access, in the same order as the accesses.
+rdcarray<DescriptorAccessRanges> CollateDescriptorAccess(const rdcarray<DescriptorAccess> &access);
+
 void StandardFillCBufferVariable(ResourceId shader, const ShaderConstantType &desc,
                                  uint32_t dataOffset, const bytebuf &data, ShaderVariable &outvar,
                                  uint32_t matStride);
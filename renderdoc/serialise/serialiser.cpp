@@ -84,6 +84,99 @@ void DumpChunk(bool reading, FileIO::LogFileHandle *log, SDChunk *chunk)
   DumpObject(log, "  ", chunk);
 }
 
+/////////////////////////////////////////////////////////////
+// String database
+
+StringDatabase::~StringDatabase()
+{
+  for(char *alloc : m_Allocations)
+    delete[] alloc;
+}
+
+const char *StringDatabase::Intern(const char *str, size_t len)
+{
+  // djb2 over the whole string (which may contain NULs), then mixed so the low bits we index the
+  // table with are well distributed
+  uint32_t hash = 5381;
+  for(size_t i = 0; i < len; i++)
+    hash = ((hash << 5) + hash) + (byte)str[i];
+  hash ^= hash >> 16;
+  hash *= 0x85ebca6b;
+  hash ^= hash >> 13;
+
+  // keep the load factor under 1/2
+  if((m_Count + 1) * 2 > m_Table.size())
+    Resize(RDCMAX(m_Table.size() * 2, (size_t)1024));
+
+  const size_t mask = m_Table.size() - 1;
+  for(size_t i = hash & mask;; i = (i + 1) & mask)
+  {
+    Entry &e = m_Table[i];
+
+    if(e.str == NULL)
+    {
+      e.str = Store(str, len);
+      e.hash = hash;
+      e.length = (uint32_t)len;
+      m_Count++;
+      return e.str;
+    }
+
+    if(e.hash == hash && e.length == len && memcmp(e.str, str, len) == 0)
+      return e.str;
+  }
+}
+
+char *StringDatabase::Store(const char *str, size_t len)
+{
+  const size_t size = len + 1;
+  char *ret = NULL;
+
+  // large strings get their own allocation rather than wasting the remainder of a page
+  if(size > PageSize / 4)
+  {
+    ret = new char[size];
+    m_Allocations.push_back(ret);
+  }
+  else
+  {
+    if(m_Page == NULL || m_PageUsed + size > PageSize)
+    {
+      m_Page = new char[PageSize];
+      m_Allocations.push_back(m_Page);
+      m_PageUsed = 0;
+    }
+
+    ret = m_Page + m_PageUsed;
+    m_PageUsed += size;
+  }
+
+  if(len > 0)
+    memcpy(ret, str, len);
+  ret[len] = 0;
+
+  return ret;
+}
+
+void StringDatabase::Resize(size_t size)
+{
+  rdcarray<Entry> oldTable;
+  oldTable.swap(m_Table);
+  m_Table.resize(size);
+
+  const size_t mask = size - 1;
+  for(const Entry &e : oldTable)
+  {
+    if(e.str == NULL)
+      continue;
+
+    size_t i = e.hash & mask;
+    while(m_Table[i].str != NULL)
+      i = (i + 1) & mask;
+    m_Table[i] = e;
+  }
+}
+
 /////////////////////////////////////////////////////////////
 // Read Serialiser functions
 
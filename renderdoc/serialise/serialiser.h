@@ -51,6 +51,24 @@ void Deserialise(const T &el)
   template void DoSerialise(Serialiser<SerialiserMode::Writing> &, type &); \
   template void DoSerialise(Serialiser<SerialiserMode::Reading> &, type &);
 
+// types whose serialised form is exactly their bytes in memory - serialised member-by-member in
+// declaration order with no padding, and no special handling of any member. Arrays of these are
+// read and written in one go when structured data isn't being exported. Enums are handled
+// automatically.
+template <class T>
+struct IsSerialisePOD
+{
+  static constexpr bool value = std::is_enum<T>::value;
+};
+
+#define DECLARE_SERIALISE_POD(type)                                                   \
+  template <>                                                                         \
+  struct IsSerialisePOD<type>                                                         \
+  {                                                                                   \
+    RDCCOMPILE_ASSERT(std::is_trivially_copyable<type>::value, "POD type isn't POD"); \
+    static constexpr bool value = true;                                               \
+  }
+
 typedef rdcstr (*ChunkLookup)(uint32_t chunkType);
 
 enum class SerialiserFlags
@@ -61,6 +79,44 @@ enum class SerialiserFlags
 
 BITMASK_OPERATORS(SerialiserFlags);
 
+// a database of interned strings, used for strings read from a file where serialised structures
+// expect a const char * that points to persistent memory. Strings are copied into paged storage so
+// returned pointers remain valid for the lifetime of the database, and looked up through a hash
+// table so that re-reading the same strings (e.g. debug markers on every replay) is cheap.
+class StringDatabase
+{
+public:
+  StringDatabase() = default;
+  ~StringDatabase();
+  StringDatabase(const StringDatabase &) = delete;
+  StringDatabase &operator=(const StringDatabase &) = delete;
+
+  const char *Intern(const char *str, size_t len);
+  const char *Intern(const rdcstr &str) { return Intern(str.c_str(), str.size()); }
+  size_t size() const { return m_Count; }
+
+private:
+  struct Entry
+  {
+    const char *str = NULL;
+    uint32_t hash = 0;
+    uint32_t length = 0;
+  };
+
+  static const size_t PageSize = 64 * 1024;
+
+  // open-addressed with linear probing, always a power of two in size
+  rdcarray<Entry> m_Table;
+  size_t m_Count = 0;
+
+  rdcarray<char *> m_Allocations;
+  char *m_Page = NULL;
+  size_t m_PageUsed = 0;
+
+  char *Store(const char *str, size_t len);
+  void Resize(size_t size);
+};
+
 // This class is used to read and write arbitrary structured data from a stream. The primary
 // mechanism is in template overloads of DoSerialise functions for each struct that can be
 // serialised, down to primitive types (ints, floats, strings, etc).
@@ -142,7 +198,7 @@ public:
   static uint64_t GetChunkAlignment() { return ChunkAlignment; }
   void *GetUserData() { return m_pUserData; }
   void SetUserData(void *userData) { m_pUserData = userData; }
-  void SetStringDatabase(std::set<rdcstr> *db) { m_ExtStringDB = db; }
+  void SetStringDatabase(StringDatabase *db) { m_ExtStringDB = db; }
   // jumps to the byte after the current chunk, can be called any time after BeginChunk
   void SkipCurrentChunk();
 
@@ -547,8 +603,7 @@ public:
     }
     else
     {
-      for(size_t i = 0; i < N && i < count; i++)
-        SerialiseDispatch<Serialiser, T>::Do(*this, el[i]);
+      SerialiseElements(el, RDCMIN((size_t)count, N));
 
       for(size_t i = N; i < count; i++)
       {
@@ -640,8 +695,8 @@ public:
       {
         PushInternal();
 
-        for(uint64_t i = 0; el && i < arrayCount; i++)
-          SerialiseDispatch<Serialiser, T>::Do(*this, el[i]);
+        if(el)
+          SerialiseElements(el, (size_t)arrayCount);
 
         PopInternal();
 
@@ -683,8 +738,8 @@ public:
       }
 #endif
 
-      for(size_t i = 0; el && i < arrayCount; i++)
-        SerialiseDispatch<Serialiser, T>::Do(*this, el[i]);
+      if(el)
+        SerialiseElements(el, (size_t)arrayCount);
     }
 
     return *this;
@@ -733,8 +788,7 @@ public:
       {
         PushInternal();
 
-        for(size_t i = 0; i < (size_t)size; i++)
-          SerialiseDispatch<Serialiser, U>::Do(*this, el[i]);
+        SerialiseElements(el.data(), (size_t)size);
 
         PopInternal();
 
@@ -764,8 +818,7 @@ public:
       if(IsReading())
         el.resize((size_t)size);
 
-      for(size_t i = 0; i < (size_t)size; i++)
-        SerialiseDispatch<Serialiser, U>::Do(*this, el[i]);
+      SerialiseElements(el.data(), (size_t)size);
     }
 
     return *this;
@@ -846,8 +899,7 @@ public:
     }
     else
     {
-      for(size_t i = 0; i < N && i < count; i++)
-        SerialiseDispatch<Serialiser, U>::Do(*this, el[i]);
+      SerialiseElements(el.data(), RDCMIN((size_t)count, N));
 
       for(size_t i = N; i < count; i++)
       {
@@ -1375,11 +1427,10 @@ public:
       }
       else
       {
-        rdcstr str;
-        str.resize(len);
+        m_StringScratch.resize(len);
         if(len > 0)
-          m_Read->Read(&str[0], len);
-        el = (char *)StringDB(str);
+          m_Read->Read(m_StringScratch.data(), len);
+        el = (char *)StringDB(m_StringScratch.c_str(), m_StringScratch.size());
       }
     }
     else
@@ -1438,8 +1489,7 @@ public:
       {
         PushInternal();
 
-        for(size_t i = 0; i < (size_t)size; i++)
-          SerialiseDispatch<Serialiser, U>::Do(*this, el[i]);
+        SerialiseElements(el.data(), (size_t)size);
 
         PopInternal();
 
@@ -1467,8 +1517,7 @@ public:
       if(IsReading())
         el.resize((size_t)size);
 
-      for(size_t i = 0; i < (size_t)size; i++)
-        SerialiseDispatch<Serialiser, U>::Do(*this, el[i]);
+      SerialiseElements(el.data(), (size_t)size);
     }
   }
 
@@ -1483,6 +1532,25 @@ protected:
   void SetStructuriser(bool s) { m_Structuriser = s; }
 private:
   static const uint64_t ChunkAlignment = 64;
+
+  // serialise array elements without any structured export. POD types can skip per-element
+  // dispatch entirely and read or write the whole array in one go.
+  template <class T>
+  void SerialiseElements(T *el, size_t count)
+  {
+    if(IsSerialisePOD<T>::value)
+    {
+      if(IsWriting())
+        m_Write->Write(el, count * sizeof(T));
+      else
+        m_Read->Read(el, count * sizeof(T));
+    }
+    else
+    {
+      for(size_t i = 0; i < count; i++)
+        SerialiseDispatch<Serialiser, T>::Do(*this, el[i]);
+    }
+  }
   template <class SerialiserMode, typename T, bool isEnum = std::is_enum<T>::value>
   struct SerialiseDispatch
   {
@@ -1548,7 +1616,7 @@ private:
     void *userData = m_pUserData;
     bool buffers = m_ExportBuffers;
     uint64_t ver = m_Version;
-    std::set<rdcstr> *stringDB = m_ExtStringDB;
+    StringDatabase *stringDB = m_ExtStringDB;
     return [lookup, userData, buffers, ver, stringDB](const void *ptr) {
       T &input = *(T *)ptr;
       static StreamReader dummy(StreamReader::DummyStream);
@@ -1607,21 +1675,20 @@ private:
 
   // a database of strings read from the file, useful when serialised structures
   // expect a char* to return and point to static memory
-  std::set<rdcstr> m_StringDB;
+  StringDatabase m_StringDB;
 
   // external storage - so the string storage can persist after the lifetime of the serialiser
-  std::set<rdcstr> *m_ExtStringDB = NULL;
+  StringDatabase *m_ExtStringDB = NULL;
+
+  // scratch storage for strings being read, before they're interned
+  rdcstr m_StringScratch;
 
-  const char *StringDB(const rdcstr &s)
+  const char *StringDB(const char *str, size_t len)
   {
     if(m_ExtStringDB)
-    {
-      auto it = m_ExtStringDB->insert(s);
-      return it.first->c_str();
-    }
+      return m_ExtStringDB->Intern(str, len);
 
-    auto it = m_StringDB.insert(s);
-    return it.first->c_str();
+    return m_StringDB.Intern(str, len);
   }
 
   ChunkLookup m_ChunkLookup = NULL;
@@ -1664,6 +1731,7 @@ public:
 #define BASIC_TYPE_SERIALISE(typeName, member, type, byteSize) \
   DECLARE_STRINGISE_TYPE(typeName)                             \
   DECLARE_STRINGISE_TYPE(rdcarray<typeName>)                   \
+  DECLARE_SERIALISE_POD(typeName);                             \
   template <class SerialiserType>                              \
   void DoSerialise(SerialiserType &ser, typeName &el)          \
   {                                                            \
@@ -22,6 +22,7 @@
  * THE SOFTWARE.
  ******************************************************************************/
 
+#include "common/timing.h"
 #include "serialiser.h"
 
 #if ENABLED(ENABLE_UNIT_TESTS)
@@ -1839,6 +1840,369 @@ void test(const char *aasd)
   RDCLOG("got a test of %s", aasd);
 }
 
+struct podStruct
+{
+  float x, y;
+  uint32_t a, b;
+};
+
+DECLARE_REFLECTION_STRUCT(podStruct);
+DECLARE_SERIALISE_POD(podStruct);
+
+template <class SerialiserType>
+void DoSerialise(SerialiserType &ser, podStruct &el)
+{
+  SERIALISE_MEMBER(x);
+  SERIALISE_MEMBER(y);
+  SERIALISE_MEMBER(a);
+  SERIALISE_MEMBER(b);
+}
+
+// identical layout, but serialised member-by-member
+struct nonPodStruct
+{
+  float x, y;
+  uint32_t a, b;
+};
+
+DECLARE_REFLECTION_STRUCT(nonPodStruct);
+
+template <class SerialiserType>
+void DoSerialise(SerialiserType &ser, nonPodStruct &el)
+{
+  SERIALISE_MEMBER(x);
+  SERIALISE_MEMBER(y);
+  SERIALISE_MEMBER(a);
+  SERIALISE_MEMBER(b);
+}
+
+TEST_CASE("Read/write arrays of POD types", "[serialiser][structured]")
+{
+  rdcarray<podStruct> pods;
+  rdcarray<nonPodStruct> nonPods;
+  rdcarray<uint16_t> shorts;
+  rdcarray<MySpecialEnum> enums;
+
+  for(uint32_t i = 0; i < 100; i++)
+  {
+    pods.push_back({float(i), float(i) * 0.5f, i * 7, ~i});
+    nonPods.push_back({float(i), float(i) * 0.5f, i * 7, ~i});
+    shorts.push_back(uint16_t(i * 3));
+    enums.push_back(i % 2 ? SecondEnumValue : TheLastEnumValue);
+  }
+
+  StreamWriter *podBuf = new StreamWriter(StreamWriter::DefaultScratchSize);
+  StreamWriter *nonPodBuf = new StreamWriter(StreamWriter::DefaultScratchSize);
+
+  {
+    WriteSerialiser ser(podBuf, Ownership::Nothing);
+
+    SCOPED_SERIALISE_CHUNK(5);
+
+    podStruct *pointer = pods.data();
+    uint64_t pointerCount = 10;
+    podStruct fixed[4] = {pods[0], pods[1], pods[2], pods[3]};
+
+    SERIALISE_ELEMENT(pods);
+    SERIALISE_ELEMENT(pointerCount);
+    SERIALISE_ELEMENT_ARRAY(pointer, pointerCount);
+    SERIALISE_ELEMENT(fixed);
+    SERIALISE_ELEMENT(shorts);
+    SERIALISE_ELEMENT(enums);
+  }
+
+  {
+    WriteSerialiser ser(nonPodBuf, Ownership::Nothing);
+
+    SCOPED_SERIALISE_CHUNK(5);
+
+    nonPodStruct *pointer = nonPods.data();
+    uint64_t pointerCount = 10;
+    nonPodStruct fixed[4] = {nonPods[0], nonPods[1], nonPods[2], nonPods[3]};
+
+    SERIALISE_ELEMENT(nonPods);
+    SERIALISE_ELEMENT(pointerCount);
+    SERIALISE_ELEMENT_ARRAY(pointer, pointerCount);
+    SERIALISE_ELEMENT(fixed);
+    SERIALISE_ELEMENT(shorts);
+    SERIALISE_ELEMENT(enums);
+  }
+
+  // the bulk copy must produce exactly the same bytes as serialising each member
+  REQUIRE(podBuf->GetOffset() == nonPodBuf->GetOffset());
+  CHECK(memcmp(podBuf->GetData(), nonPodBuf->GetData(), (size_t)podBuf->GetOffset()) == 0);
+
+  {
+    ReadSerialiser ser(new StreamReader(podBuf->GetData(), podBuf->GetOffset()),
+                       Ownership::Stream);
+
+    ser.ConfigureStructuredExport([](uint32_t) -> rdcstr { return "TestChunk"; }, true, 0, 1.0);
+
+    SDFile &structData = ser.GetStructuredFile();
+
+    ser.ReadChunk<uint32_t>();
+    {
+      rdcarray<podStruct> readPods;
+      podStruct *pointer = NULL;
+      uint64_t pointerCount = 0;
+      podStruct fixed[4] = {};
+      rdcarray<uint16_t> readShorts;
+      rdcarray<MySpecialEnum> readEnums;
+
+      SERIALISE_ELEMENT(readPods);
+      SERIALISE_ELEMENT(pointerCount);
+      SERIALISE_ELEMENT_ARRAY(pointer, pointerCount);
+      SERIALISE_ELEMENT(fixed);
+      SERIALISE_ELEMENT(readShorts);
+      SERIALISE_ELEMENT(readEnums);
+
+      REQUIRE(readPods.size() == pods.size());
+      CHECK(memcmp(readPods.data(), pods.data(), pods.byteSize()) == 0);
+      REQUIRE(pointerCount == 10);
+      CHECK(memcmp(pointer, pods.data(), sizeof(podStruct) * 10) == 0);
+      CHECK(memcmp(fixed, pods.data(), sizeof(fixed)) == 0);
+      CHECK(readShorts == shorts);
+      CHECK(readEnums == enums);
+    }
+    ser.EndChunk();
+
+    REQUIRE(structData.chunks.size() == 1);
+    const SDChunk &chunk = *structData.chunks[0];
+    REQUIRE(chunk.NumChildren() == 6);
+
+    // structured export still sees every member of every element
+    const SDObject &o = *chunk.GetChild(0);
+    REQUIRE(o.NumChildren() == 100);
+    CHECK(o.GetChild(42)->FindChild("a")->AsUInt32() == 42 * 7);
+    CHECK(o.GetChild(42)->FindChild("y")->AsFloat() == 21.0f);
+    CHECK(chunk.GetChild(2)->NumChildren() == 10);
+    CHECK(chunk.GetChild(3)->NumChildren() == 4);
+    CHECK(chunk.GetChild(4)->GetChild(99)->AsUInt16() == 99 * 3);
+    CHECK(chunk.GetChild(5)->GetChild(1)->AsString() == "SecondEnumValue");
+  }
+
+  delete podBuf;
+  delete nonPodBuf;
+}
+
+TEST_CASE("Benchmark serialising arrays of POD types", "[.][serialiser][benchmark]")
+{
+  const size_t count = 4 * 1024 * 1024;
+
+  rdcarray<podStruct> pods;
+  pods.resize(count);
+  rdcarray<nonPodStruct> nonPods;
+  nonPods.resize(count);
+
+  for(size_t i = 0; i < count; i++)
+  {
+    pods[i] = {float(i), float(i) * 0.5f, uint32_t(i), uint32_t(i * 3)};
+    nonPods[i] = {float(i), float(i) * 0.5f, uint32_t(i), uint32_t(i * 3)};
+  }
+
+  StreamWriter *buf = new StreamWriter(count * sizeof(podStruct) + 1024);
+
+  double podWrite, nonPodWrite, podRead, nonPodRead;
+
+  {
+    buf->Rewind();
+    WriteSerialiser ser(buf, Ownership::Nothing);
+    PerformanceTimer timer;
+    {
+      SCOPED_SERIALISE_CHUNK(5);
+      SERIALISE_ELEMENT(pods);
+    }
+    podWrite = timer.GetMilliseconds();
+  }
+
+  {
+    ReadSerialiser ser(new StreamReader(buf->GetData(), buf->GetOffset()), Ownership::Stream);
+    PerformanceTimer timer;
+    ser.ReadChunk<uint32_t>();
+    SERIALISE_ELEMENT(pods);
+    ser.EndChunk();
+    podRead = timer.GetMilliseconds();
+  }
+
+  {
+    buf->Rewind();
+    WriteSerialiser ser(buf, Ownership::Nothing);
+    PerformanceTimer timer;
+    {
+      SCOPED_SERIALISE_CHUNK(5);
+      SERIALISE_ELEMENT(nonPods);
+    }
+    nonPodWrite = timer.GetMilliseconds();
+  }
+
+  {
+    ReadSerialiser ser(new StreamReader(buf->GetData(), buf->GetOffset()), Ownership::Stream);
+    PerformanceTimer timer;
+    ser.ReadChunk<uint32_t>();
+    SERIALISE_ELEMENT(nonPods);
+    ser.EndChunk();
+    nonPodRead = timer.GetMilliseconds();
+  }
+
+  CHECK(memcmp(pods.data(), nonPods.data(), pods.byteSize()) == 0);
+
+  RDCLOG("%u structs: bulk write %.2f ms, read %.2f ms. per-member write %.2f ms, read %.2f ms",
+         (uint32_t)count, podWrite, podRead, nonPodWrite, nonPodRead);
+
+  delete buf;
+}
+
+TEST_CASE("String database interning", "[serialiser]")
+{
+  StringDatabase db;
+
+  SECTION("Identical strings return the same pointer")
+  {
+    const char *a = db.Intern("foobar");
+    const char *b = db.Intern(rdcstr("foo") + "bar");
+    const char *c = db.Intern("foobaz");
+
+    CHECK(a == b);
+    CHECK(a != c);
+    CHECK(rdcstr(a) == "foobar");
+    CHECK(rdcstr(c) == "foobaz");
+    CHECK(db.size() == 2);
+  };
+
+  SECTION("Empty strings and embedded NULs are distinct")
+  {
+    const char *empty = db.Intern("", 0);
+    const char *nul = db.Intern("\0", 1);
+    const char *nul2 = db.Intern("a\0b", 3);
+    const char *nul3 = db.Intern("a\0c", 3);
+
+    CHECK(empty != nul);
+    CHECK(nul2 != nul3);
+    CHECK(empty[0] == 0);
+    CHECK(db.Intern("", 0) == empty);
+    CHECK(db.Intern("a\0b", 3) == nul2);
+    CHECK(db.size() == 4);
+  };
+
+  SECTION("Pointers stay valid as the database grows")
+  {
+    rdcarray<const char *> ptrs;
+
+    for(int i = 0; i < 50000; i++)
+      ptrs.push_back(db.Intern(StringFormat::Fmt("Marker string %d", i)));
+
+    // a few strings larger than a page
+    rdcstr big;
+    big.resize(200000);
+    for(size_t i = 0; i < big.size(); i++)
+      big[i] = char('a' + (i % 26));
+    const char *bigPtr = db.Intern(big);
+
+    CHECK(db.size() == 50001);
+
+    for(int i = 0; i < 50000; i++)
+    {
+      rdcstr expected = StringFormat::Fmt("Marker string %d", i);
+      CHECK(ptrs[i] == db.Intern(expected));
+      CHECK(rdcstr(ptrs[i]) == expected);
+    }
+
+    CHECK(bigPtr == db.Intern(big));
+    CHECK(rdcstr(bigPtr) == big);
+    CHECK(db.size() == 50001);
+  };
+
+  SECTION("Serialised strings are interned into an external database")
+  {
+    StreamWriter *buf = new StreamWriter(StreamWriter::DefaultScratchSize);
+
+    {
+      WriteSerialiser ser(buf, Ownership::Nothing);
+
+      for(int i = 0; i < 10; i++)
+      {
+        SCOPED_SERIALISE_CHUNK(5);
+        const char *marker = (i % 2) ? "Odd marker" : "Even marker";
+        SERIALISE_ELEMENT(marker);
+      }
+    }
+
+    rdcarray<const char *> markers;
+
+    {
+      ReadSerialiser ser(new StreamReader(buf->GetData(), buf->GetOffset()), Ownership::Stream);
+      ser.SetStringDatabase(&db);
+
+      for(int i = 0; i < 10; i++)
+      {
+        ser.ReadChunk<uint32_t>();
+        const char *marker = NULL;
+        SERIALISE_ELEMENT(marker);
+        markers.push_back(marker);
+        ser.EndChunk();
+      }
+    }
+
+    // the serialiser is gone, the strings must persist in the database
+    CHECK(db.size() == 2);
+    for(int i = 0; i < 10; i++)
+    {
+      CHECK(markers[i] == markers[i % 2]);
+      CHECK(rdcstr(markers[i]) == ((i % 2) ? "Odd marker" : "Even marker"));
+    }
+
+    delete buf;
+  };
+}
+
+TEST_CASE("Benchmark string interning", "[.][serialiser][benchmark]")
+{
+  // synthetic marker-heavy capture: lots of chunks, each with a marker from a smaller set of names
+  const int numChunks = 500000;
+  const int numNames = 5000;
+
+  rdcarray<rdcstr> names;
+  for(int i = 0; i < numNames; i++)
+    names.push_back(StringFormat::Fmt("Render pass %d: draw opaque geometry batch", i));
+
+  StreamWriter *buf = new StreamWriter(StreamWriter::DefaultScratchSize);
+
+  {
+    WriteSerialiser ser(buf, Ownership::Nothing);
+
+    for(int i = 0; i < numChunks; i++)
+    {
+      SCOPED_SERIALISE_CHUNK(5);
+      const char *marker = names[(uint32_t(i) * 7919U) % numNames].c_str();
+      SERIALISE_ELEMENT(marker);
+    }
+  }
+
+  StringDatabase db;
+
+  // replay the capture a few times with the same database, as happens when seeking around
+  for(int replay = 0; replay < 3; replay++)
+  {
+    ReadSerialiser ser(new StreamReader(buf->GetData(), buf->GetOffset()), Ownership::Stream);
+    ser.SetStringDatabase(&db);
+
+    PerformanceTimer timer;
+    for(int i = 0; i < numChunks; i++)
+    {
+      ser.ReadChunk<uint32_t>();
+      const char *marker = NULL;
+      SERIALISE_ELEMENT(marker);
+      ser.EndChunk();
+    }
+
+    RDCLOG("Replay %d of %d marker chunks: %.2f ms", replay, numChunks, timer.GetMilliseconds());
+  }
+
+  CHECK(db.size() == (size_t)numNames);
+
+  delete buf;
+}
+
 TEST_CASE("Test stringification works as expected", "[tostr]")
 {
   SECTION("Enum classes")
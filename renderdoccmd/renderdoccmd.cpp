@@ -26,6 +26,7 @@
 #include "renderdoccmd.h"
 #include <app/renderdoc_app.h>
 #include <replay/version.h>
+#include <chrono>
 #include <string>
 
 rdcstr conv(const std::string &s)
@@ -835,6 +836,186 @@ public:
   }
 };
 
+struct BenchCommand : public Command
+{
+private:
+  std::string filename;
+  std::string outdir;
+  std::string format;
+  std::string compress;
+  uint32_t numTextures = 0;
+  uint32_t repeats = 0;
+
+  typedef std::chrono::high_resolution_clock clock;
+
+  static double msSince(clock::time_point start)
+  {
+    return std::chrono::duration<double, std::milli>(clock::now() - start).count();
+  }
+
+public:
+  BenchCommand() : Command() {}
+  virtual void AddOptions(cmdline::parser &parser)
+  {
+    parser.set_footer("<capture.rdc>");
+    parser.add<std::string>("output-dir", 'o', "The directory to save textures to.", true);
+    parser.add<std::string>(
+        "format", 'f', "The file format to save textures as.", false, "png",
+        cmdline::oneof<std::string>("dds", "png", "jpg", "bmp", "tga", "hdr", "exr"));
+    parser.add<std::string>(
+        "block-compress", 'c', "When saving as dds, block compress to this format.", false, "",
+        cmdline::oneof<std::string>("", "bc1", "bc2", "bc3", "bc4", "bc5", "bc6", "bc7"));
+    parser.add<uint32_t>("textures", 'n', "How many textures to save, largest first.", false, 16);
+    parser.add<uint32_t>("repeat", 'r', "How many times to repeat the saves.", false, 1);
+  }
+  virtual const char *Description()
+  {
+    return "Replay a capture and time saving its largest textures to disk.";
+  }
+  virtual bool IsInternalOnly() { return false; }
+  virtual bool IsCaptureCommand() { return false; }
+  virtual bool Parse(cmdline::parser &parser, GlobalEnvironment &)
+  {
+    std::vector<std::string> rest = parser.rest();
+    if(rest.empty())
+    {
+      std::cerr << "Error: bench command requires a capture filename." << std::endl
+                << std::endl
+                << parser.usage();
+      return false;
+    }
+
+    filename = rest[0];
+
+    rest.erase(rest.begin());
+
+    parser.set_rest(rest);
+
+    outdir = parser.get<std::string>("output-dir");
+    format = parser.get<std::string>("format");
+    compress = parser.get<std::string>("block-compress");
+    numTextures = parser.get<uint32_t>("textures");
+    repeats = std::max(1U, parser.get<uint32_t>("repeat"));
+
+    return true;
+  }
+
+  virtual int Execute(const CaptureOptions &)
+  {
+    FileType type = FileType::PNG;
+    if(format == "dds")
+      type = FileType::DDS;
+    else if(format == "jpg")
+      type = FileType::JPG;
+    else if(format == "bmp")
+      type = FileType::BMP;
+    else if(format == "tga")
+      type = FileType::TGA;
+    else if(format == "hdr")
+      type = FileType::HDR;
+    else if(format == "exr")
+      type = FileType::EXR;
+
+    ICaptureFile *file = RENDERDOC_OpenCaptureFile();
+
+    ResultDetails res = file->OpenFile(conv(filename), "rdc", NULL);
+
+    if(res.code != ResultCode::Succeeded)
+    {
+      std::cerr << "Couldn't load '" << filename << "': " << res.Message() << std::endl;
+      file->Shutdown();
+      return 1;
+    }
+
+    IReplayController *renderer = NULL;
+    rdctie(res, renderer) = file->OpenCapture(ReplayOptions(), NULL);
+
+    file->Shutdown();
+
+    if(!res.OK())
+    {
+      std::cerr << "Couldn't load and replay '" << filename << "': " << res.Message() << std::endl;
+      return 1;
+    }
+
+    // save textures as they are at the end of the frame
+    rdcarray<ActionDescription> actions = renderer->GetRootActions();
+    if(!actions.empty())
+      renderer->SetFrameEvent(actions.back().eventId, true);
+
+    rdcarray<TextureDescription> texs = renderer->GetTextures();
+
+    std::sort(texs.begin(), texs.end(),
+              [](const TextureDescription &a, const TextureDescription &b) {
+                return uint64_t(a.width) * a.height * a.depth >
+                       uint64_t(b.width) * b.height * b.depth;
+              });
+
+    if(texs.size() > numTextures)
+      texs.resize(numTextures);
+
+    uint64_t totalTexels = 0;
+    for(const TextureDescription &tex : texs)
+      totalTexels += uint64_t(tex.width) * tex.height * tex.depth;
+
+    std::cout << "Saving " << texs.size() << " textures as " << format << ", " << repeats
+              << " time(s)" << std::endl;
+
+    double totalMS = 0.0;
+    uint32_t failures = 0;
+
+    for(uint32_t r = 0; r < repeats; r++)
+    {
+      for(size_t i = 0; i < texs.size(); i++)
+      {
+        TextureSave save;
+        save.resourceId = texs[i].resourceId;
+        save.destType = type;
+        save.mip = 0;
+        save.slice.sliceIndex = 0;
+        save.alpha = AlphaMapping::Preserve;
+
+        if(!compress.empty())
+          save.blockCompression =
+              ResourceFormatType(uint32_t(ResourceFormatType::BC1) + uint32_t(compress[2] - '1'));
+
+        std::string path = outdir + "/tex" + std::to_string(i) + "." + format;
+
+        clock::time_point start = clock::now();
+        res = renderer->SaveTexture(save, conv(path));
+        double ms = msSince(start);
+
+        totalMS += ms;
+
+        if(!res.OK())
+        {
+          failures++;
+          if(r == 0)
+            std::cerr << "  Failed to save " << ToStr(texs[i].resourceId) << ": "
+                      << res.Message() << std::endl;
+        }
+        else if(r == 0)
+        {
+          std::cout << "  " << texs[i].width << "x" << texs[i].height << " "
+                    << texs[i].format.Name() << ": " << ms << " ms" << std::endl;
+        }
+      }
+    }
+
+    renderer->Shutdown();
+
+    const double avgMS = totalMS / repeats;
+
+    std::cout << "Average " << avgMS << " ms per pass over " << texs.size() << " textures, "
+              << (double(totalTexels) / 1000000.0) / (avgMS / 1000.0) << " Mtexels/s" << std::endl;
+
+    if(failures > 0)
+      std::cerr << failures << " saves failed." << std::endl;
+
+    return failures > 0 ? 1 : 0;
+  }
+};
+
 struct TestCommand : public Command
 {
 private:
@@ -1572,6 +1753,7 @@ int renderdoccmd(GlobalEnvironment &env, std::vector<std::string> &argv)
     add_command("capaltbit", new CapAltBitCommand());
     add_command("test", new TestCommand());
     add_command("convert", new ConvertCommand());
+    add_command("bench", new BenchCommand());
     add_command("embed", new EmbeddedSectionCommand(false));
     add_command("extract", new EmbeddedSectionCommand(true));
 #endif    // !defined(RDOC_SELFCAPTURE_LIMITEDAPI)
@@ -0,0 +1,108 @@
+import rdtest
+import os
+import random
+import time
+import renderdoc as rd
+
+
+class Seek_Latency(rdtest.TestCase):
+    slow_test = True
+
+    num_seeks = 50
+    checkpoint_budget_mb = 512
+
+    def set_checkpoint_budget(self, budget_mb: int):
+        setting = rd.SetConfigSetting('Vulkan.ReplayCheckpointBudgetMB')
+        if setting is not None:
+            setting.data.basic.u = budget_mb
+
+    def get_output_data(self, controller: rd.ReplayController):
+        pipe: rd.PipeState = controller.GetPipelineState()
+
+        for res in pipe.GetOutputTargets():
+            if res.resource != rd.ResourceId.Null():
+                sub = rd.Subresource(res.firstMip, res.firstSlice, 0)
+                return controller.GetTextureData(res.resource, sub)
+
+        return None
+
+    def time_seeks(self, path, events, label):
+        try:
+            controller = rdtest.open_capture(path)
+        except RuntimeError as err:
+            rdtest.log.print("Skipping. Can't open {}: {}".format(path, err))
+            return None, None
+
+        timings = []
+        outputs = {}
+
+        for eid in events:
+            start = time.perf_counter()
+            controller.SetFrameEvent(eid, True)
+            timings.append(time.perf_counter() - start)
+
+            # only compare a handful of results, reading back is much slower than seeking
+            if len(outputs) < 5:
+                outputs[eid] = self.get_output_data(controller)
+
+        controller.Shutdown()
+
+        timings.sort()
+        rdtest.log.print("{}: median seek {:.2f} ms, worst {:.2f} ms, total {:.2f} ms"
+                         .format(label, timings[len(timings) // 2] * 1000.0, timings[-1] * 1000.0,
+                                 sum(timings) * 1000.0))
+
+        return timings, outputs
+
+    def seek_latency(self, path):
+        try:
+            controller = rdtest.open_capture(path)
+        except RuntimeError as err:
+            rdtest.log.print("Skipping. Can't open {}: {}".format(path, err))
+            return
+
+        actions = []
+        action = controller.GetRootActions()[0]
+        while action is not None:
+            if action.flags & (rd.ActionFlags.Drawcall | rd.ActionFlags.Dispatch):
+                actions.append(action.eventId)
+            action = action.next
+
+        controller.Shutdown()
+
+        if len(actions) == 0:
+            rdtest.log.print("No actions to seek to")
+            return
+
+        # seek randomly, but deterministically so both runs see the same sequence
+        rng = random.Random(len(actions))
+        events = [rng.choice(actions) for i in range(self.num_seeks)]
+
+        self.set_checkpoint_budget(0)
+        base_timings, base_outputs = self.time_seeks(path, events, "No checkpoints")
+
+        self.set_checkpoint_budget(self.checkpoint_budget_mb)
+        timings, outputs = self.time_seeks(path, events, "Checkpoints")
+
+        self.set_checkpoint_budget(0)
+
+        if base_timings is None or timings is None:
+            return
+
+        for eid in base_outputs:
+            if base_outputs[eid] != outputs[eid]:
+                raise rdtest.TestFailureException("Output at {} differs when replaying with checkpoints"
+                                                  .format(eid))
+
+        rdtest.log.success("Checkpointed seeks took {:.2f}% of the baseline time"
+                           .format(sum(timings) / max(sum(base_timings), 1e-9) * 100.0))
+
+    def run(self):
+        dir_path = self.get_ref_path('', extra=True)
+
+        for file in os.scandir(dir_path):
+            rdtest.log.print('Measuring seek latency in {}'.format(file.name))
+
+            self.seek_latency(file.path)
+
+            rdtest.log.success("Measured seek latency in {}".format(file.name))